@@ -0,0 +1,33 @@
+# Driver a riga di comando del convex hull, linkato alla libreria headless
+# (compilare prima ConvexHullCore.pro).
+
+TEMPLATE = app
+TARGET = ConvexHullCli
+CONFIG += console
+CONFIG -= app_bundle
+QT += core gui
+QT -= opengl xml widgets
+
+INCLUDEPATH += $$PWD
+LIBS += -L$$OUT_PWD -lConvexHullCore
+PRE_TARGETDEPS += $$OUT_PWD/libConvexHullCore.a
+
+unix:!macx{
+    LIBS += -lboost_system -frounding-math -lgmp -lCGAL -lpthread
+    DEFINES += CGAL_DEFINED
+    QMAKE_CXXFLAGS += -std=c++11
+}
+
+macx{
+    CONFIG += c++11
+    DEFINES += CGAL_DEFINED
+    INCLUDEPATH += -I /libs/include/boost/
+    INCLUDEPATH += -I /libs/include/CGAL/
+    INCLUDEPATH += -I /usr/include/eigen3
+    LIBS += -frounding-math
+    LIBS += -L/libs/lib/gmp -lgmp
+    LIBS += -L/libs/lib/CGAL -lCGAL
+}
+
+SOURCES += \
+    GUI/ConvexHullCore/convexhull_cli.cpp
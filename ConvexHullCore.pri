@@ -0,0 +1,47 @@
+# Sorgenti dell'algoritmo del convex hull, condivisi tra la libreria headless
+# (ConvexHullCore.pro) e l'applicazione grafica: ConvexHull.pro deve includerlo con
+# include(ConvexHullCore.pri) al posto delle sue righe GUI/ConvexHullCore/ (vedi README.md).
+
+HEADERS += \
+    GUI/ConvexHullCore/convexhullcore.h \
+    GUI/ConvexHullCore/convexhullbatch.h \
+    GUI/ConvexHullCore/convexhulllog.h \
+    GUI/ConvexHullCore/convexhullplayer.h \
+    GUI/ConvexHullCore/convexhullrenderbuffer.h \
+    GUI/ConvexHullCore/convexhullstream.h \
+    GUI/ConvexHullCore/convexhulltrace.h \
+    GUI/ConvexHullCore/convexhullworker.h \
+    GUI/ConvexHullCore/conflictgraph.h \
+    GUI/ConvexHullCore/convexhullstats.h \
+    GUI/ConvexHullCore/outsidesets.h \
+    GUI/ConvexHullCore/pointbuffer.h \
+    GUI/ConvexHullCore/pointcloudfile.h \
+    GUI/ConvexHullCore/pointspan.h \
+    GUI/ConvexHullCore/predicates.h \
+    GUI/ConvexHullCore/threadpool.h \
+    GUI/ConvexHullCore/visibilitykernels.h
+
+SOURCES += \
+    GUI/ConvexHullCore/convexhullcore.cpp \
+    GUI/ConvexHullCore/convexhullbatch.cpp \
+    GUI/ConvexHullCore/convexhulllog.cpp \
+    GUI/ConvexHullCore/convexhullplayer.cpp \
+    GUI/ConvexHullCore/convexhullrenderbuffer.cpp \
+    GUI/ConvexHullCore/convexhullstream.cpp \
+    GUI/ConvexHullCore/convexhulltrace.cpp \
+    GUI/ConvexHullCore/convexhullworker.cpp \
+    GUI/ConvexHullCore/conflictgraph.cpp \
+    GUI/ConvexHullCore/outsidesets.cpp \
+    GUI/ConvexHullCore/pointcloudfile.cpp \
+    GUI/ConvexHullCore/predicates.cpp \
+    GUI/ConvexHullCore/threadpool.cpp \
+    GUI/ConvexHullCore/visibilitykernels.cpp
+
+# Oggetto disegnabile del convex hull parziale, solo nell'applicazione grafica
+contains(QT, opengl) {
+    HEADERS += GUI/ConvexHullCore/drawableconvexhull.h
+    SOURCES += GUI/ConvexHullCore/drawableconvexhull.cpp
+}
+
+# std::thread (ThreadPool) richiede pthread su linux
+unix:!macx: LIBS += -lpthread
@@ -0,0 +1,58 @@
+# Libreria headless del convex hull: contiene solo la Dcel e l'algoritmo,
+# senza OpenGL, QGLViewer e interfaccia grafica. Va affiancata a ConvexHull.pro.
+
+TEMPLATE = lib
+CONFIG += staticlib
+TARGET = ConvexHullCore
+QT += core gui
+QT -= opengl xml widgets
+
+INCLUDEPATH += $$PWD
+
+CONFIG(debug, debug|release){
+    message(debug)
+    DEFINES += DEBUG
+}
+
+# Decommentare per raccogliere le statistiche di findConvexHull() (ConvexHullCore::getStats())
+#DEFINES += CONVEXHULL_STATS
+
+# Decommentare per tracciare le fasi di findConvexHull() (ConvexHullTrace, ConvexHullCli --trace)
+#DEFINES += CONVEXHULL_TRACE
+
+unix:!macx{
+    DEFINES += CGAL_DEFINED
+    QMAKE_CXXFLAGS += -std=c++11 -frounding-math
+}
+
+macx{
+    CONFIG += c++11
+    DEFINES += CGAL_DEFINED
+    INCLUDEPATH += -I /libs/include/boost/
+    INCLUDEPATH += -I /libs/include/CGAL/
+    INCLUDEPATH += -I /usr/include/eigen3
+    QMAKE_CXXFLAGS += -frounding-math
+}
+
+HEADERS += \
+    lib/common/bounding_box.h \
+    lib/common/comparators.h \
+    lib/common/point.h \
+    lib/common/common.h \
+    lib/common/serialize.h \
+    lib/dcel/dcel.h \
+    lib/dcel/dcel_face.h \
+    lib/dcel/dcel_face_iterators.h \
+    lib/dcel/dcel_half_edge.h \
+    lib/dcel/dcel_iterators.h \
+    lib/dcel/dcel_struct.h \
+    lib/dcel/dcel_vertex.h \
+    lib/dcel/dcel_vertex_iterators.h
+
+SOURCES += \
+    lib/dcel/dcel_face.cpp \
+    lib/dcel/dcel_half_edge.cpp \
+    lib/dcel/dcel_vertex.cpp \
+    lib/dcel/dcel_struct.cpp
+
+include(ConvexHullCore.pri)
@@ -12,14 +12,63 @@
  *********************************************************************/
 
 /**
- * @brief ConflictGraph::ConflictGraph(DrawableDcel *dcel, std::vector<Dcel::Vertex *> vertexS)
+ * @brief ConflictGraph::ConflictGraph(Dcel *dcel, const PointBuffer &points)
  * This method is the constructor of the ConflictGraph class, it receive the pointer of the dcel
- * and the points.
+ * and the coordinates of the points (in the order of vertexS). The points are referenced by their index,
+ * the faces by their id in the dcel.
+ * If stats is not null (and CONVEXHULL_STATS is defined) the counters of the CG are updated there.
  */
-ConflictGraph::ConflictGraph(DrawableDcel *Dcel,const std::vector<Dcel::Vertex*> &vertexS,const int numberVertex):numberVertex(numberVertex){
+ConflictGraph::ConflictGraph(Dcel *dcel,const PointBuffer &points, ConvexHullStats* stats):numberVertex(points.size()), points(points), stats(stats), threadPool(nullptr){
 
-    this -> dcel         = Dcel;
-    this -> vertexS      = vertexS;
+    this -> dcel         = dcel;
+    this -> freeConflict = -1;
+    this -> f_conflict   = std::vector<int>(numberVertex, -1);
+    this -> vertexMark   = std::vector<unsigned int>(numberVertex, 0);
+    this -> markEpoch    = 0;
+}
+
+/**
+ * @brief ConflictGraph::computePlane()
+ * This method compute (and save) the plane of a triangular face. The normal is the cross product
+ * (v1-v0)x(v2-v0) of the vertices in the order of the half edges, so the points that see the face
+ * are the ones with a positive value of the plane equation, that is Predicates::orient3d(v0, v1, v2, p) > 0.
+ * Together with the plane is saved a bound of the rounding error of its evaluation on any input point
+ * (semi-static: it depends on the face and on the biggest coordinate of the input), so that only the
+ * values inside the bound need the exact predicate
+ * @return the plane of the face
+ */
+const FacePlane& ConflictGraph::computePlane(Dcel::Face* face){
+
+    unsigned int faceId = face->getId();
+    if(faceId >= planes.size()){
+        planes.resize(faceId+1);
+    }
+
+    Dcel::HalfEdge* halfEdge = face->getOuterHalfEdge();
+    Pointd p0 = halfEdge->getFromVertex()->getCoordinate();
+    Pointd p1 = halfEdge->getNext()->getFromVertex()->getCoordinate();
+    Pointd p2 = halfEdge->getNext()->getNext()->getFromVertex()->getCoordinate();
+
+    FacePlane& plane = planes[faceId];
+    plane = VisibilityKernels::computePlane(p0, p1, p2, points.getMaxAbsCoordinate());
+    return plane;
+}
+
+/**
+ * @brief ConflictGraph::getFacePlane()
+ * This method return the cached plane of a face already inserted in the CG
+ */
+const FacePlane& ConflictGraph::getFacePlane(Dcel::Face* face) const{
+    return planes[face->getId()];
+}
+
+/**
+ * @brief ConflictGraph::setThreadPool()
+ * This method set the thread pool used by initializeCG() and updateCG() when there are enough visibility tests
+ * (nullptr, the default, means that everything is executed by the calling thread)
+ */
+void ConflictGraph::setThreadPool(ThreadPool* threadPool){
+    this -> threadPool = threadPool;
 }
 
 /**
@@ -29,128 +78,328 @@ ConflictGraph::ConflictGraph(DrawableDcel *Dcel,const std::vector<Dcel::Vertex*>
  * t > 4 (because the 4 points are already in the dcel)
  */
 void ConflictGraph::initializeCG(){
+    CH_TRACE("initializeCG");
 
-    //Uso Eigen, come consigliato nelle slide. Libreria ottiminizzata per le matrici.
-    Eigen::Matrix<double,4,4> matrix;
-
-    //Per ogni faccia presente nella dcel, (sono 4)
+    //Il piano viene calcolato una volta sola per faccia (sono 4)
+    std::vector<Dcel::Face*> faces;
     for (Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit){
+        computePlane(*fit);
+        faces.push_back(*fit);
+    }
+
+    int numberPoints = std::max(numberVertex-4, 0);
+    CH_STATS(if(stats) stats->orientationTests += (unsigned long long) numberPoints * faces.size());
+    if(threadPool != nullptr && threadPool->getNumberThreads() > 1 && numberPoints >= 2*PARALLEL_GRAIN){
+        initializeCGParallel(faces);
+        return;
+    }
+
+    //Per ogni faccia presente nella dcel
+    unsigned long long exactTests = 0;
+    for (std::vector<Dcel::Face*>::iterator fit = faces.begin(); fit != faces.end(); ++fit){
         Dcel::Face* face= *fit;
+        const FacePlane& plane = planes[face->getId()];
+
+        //Controllo per ogni faccia quali vertici siano in conflitto, il kernel li classifica tutti in una passata
+        //scartando quelli che stanno certamente dietro la faccia: dei candidati rimasti, quelli con segno incerto
+        //vengono decisi dal predicato esatto, gli altri vedono la faccia e quindi gli isnerisco nel CG
+        visibleBuffer.resize(numberPoints);
+        int numberCandidates = VisibilityKernels::classifyRange(plane, points, 4, numberVertex, -plane.errorBound, visibleBuffer.data());
+        int numberVisible    = confirmVisible(face, plane, visibleBuffer.data(), numberCandidates, exactTests);
+        for(int i=0; i<numberVisible; i++){
+            addConflict(visibleBuffer[i], face);
+        }
+    }
+    CH_STATS(if(stats) stats->exactOrientationTests += exactTests);
+}
 
-        int k=0;
-        Dcel::HalfEdge* halfEdge = face->getOuterHalfEdge();
-
-        for(int i=0;i<3;i++,k++){
-            Dcel::Vertex* vertex = halfEdge->getFromVertex();
-            Pointd p= vertex->getCoordinate();
-            matrix(k,0) = p.x();
-            matrix(k,1) = p.y();
-            matrix(k,2) = p.z();
-            matrix(k,3) = 1;
-            halfEdge = halfEdge->getNext();
+/**
+ * @brief ConflictGraph::initializeCGParallel()
+ * This method build the same ConflictGraph of initializeCG() splitting the points in blocks: every block is
+ * classified against all the faces by a thread, then the arcs are written in parallel in positions computed
+ * in advance (every block owns its points and a range of every face list), so no lock is needed
+ */
+void ConflictGraph::initializeCGParallel(const std::vector<Dcel::Face*>& faces){
+
+    int numberFaces  = faces.size();
+    int numberBlocks = (numberVertex - 4 + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+
+    //Prima passata: ogni blocco di punti trova i suoi punti visibili da ogni faccia
+    std::vector<std::vector<int> > blockVisible(numberBlocks * numberFaces);
+    std::vector<unsigned long long> blockExactTests(numberBlocks, 0);
+    threadPool->parallelFor(0, numberBlocks, 1, [&](int firstBlock, int lastBlock){
+        for(int block=firstBlock; block<lastBlock; block++){
+            CH_TRACE("classifyBlock");
+            int begin = 4 + block*PARALLEL_GRAIN;
+            int end   = std::min(begin + PARALLEL_GRAIN, numberVertex);
+            for(int f=0; f<numberFaces; f++){
+                const FacePlane& plane = planes[faces[f]->getId()];
+                std::vector<int>& visible = blockVisible[block*numberFaces + f];
+                visible.resize(end - begin);
+                int numberCandidates = VisibilityKernels::classifyRange(plane, points, begin, end, -plane.errorBound, visible.data());
+                visible.resize(confirmVisible(faces[f], plane, visible.data(), numberCandidates, blockExactTests[block]));
+            }
+        }
+    });
+
+    //Posizioni: gli archi del blocco b partono da blockBegin[b], i suoi punti nella lista della faccia f da faceSlot[b][f]
+    std::vector<int> blockBegin(numberBlocks+1, conflicts.size());
+    std::vector<int> faceSlot(numberBlocks * numberFaces);
+    std::vector<int> faceSize(numberFaces);
+    for(int f=0; f<numberFaces; f++){
+        unsigned int faceId = faces[f]->getId();
+        if(faceId >= v_conflict.size()){
+            v_conflict.resize(faceId+1);
         }
-        //Controllo per ogni faccia quali vertici siano in conflitto
-        for(int point=4; point<numberVertex; point++){
-            Pointd p=vertexS[point]->getCoordinate();
-            matrix(3,0) = p.x();
-            matrix(3,1) = p.y();
-            matrix(3,2) = p.z();
-            matrix(3,3) = 1;
-            //se il determinante è <0 vuol dire che la faccia vede il punto quindi gli isnerisco nel CG
-            if(matrix.determinant() <- std::numeric_limits<double>::epsilon()){//nella
-                addFaceToVertex( face, vertexS[point]);
-                addVertexToFace( vertexS[point], face);
+        faceSize[f] = v_conflict[faceId].points.size();
+    }
+    for(int block=0; block<numberBlocks; block++){
+        blockBegin[block+1] = blockBegin[block];
+        for(int f=0; f<numberFaces; f++){
+            int numberVisible = blockVisible[block*numberFaces + f].size();
+            faceSlot[block*numberFaces + f] = faceSize[f];
+            faceSize[f]          += numberVisible;
+            blockBegin[block+1]  += numberVisible;
+        }
+    }
+    conflicts.resize(blockBegin[numberBlocks]);
+    for(int f=0; f<numberFaces; f++){
+        FaceConflicts& faceConflicts = v_conflict[faces[f]->getId()];
+        CH_STATS(if(stats && faceConflicts.points.empty() && faceSize[f] > 0) stats->facesWithConflicts++);
+        faceConflicts.points.resize(faceSize[f]);
+        faceConflicts.conflicts.resize(faceSize[f]);
+    }
+
+    //Seconda passata: ogni blocco scrive i suoi archi, nello stesso ordine di addConflict() (facce nell'ordine della dcel,
+    //inserimento in testa alla lista del punto), quindi il CG è identico a quello costruito in serie
+    std::vector<int> blockNewVertex(numberBlocks, 0);
+    threadPool->parallelFor(0, numberBlocks, 1, [&](int firstBlock, int lastBlock){
+        for(int block=firstBlock; block<lastBlock; block++){
+            CH_TRACE("writeBlockArcs");
+            int conflict = blockBegin[block];
+            for(int f=0; f<numberFaces; f++){
+                Dcel::Face* face = faces[f];
+                FaceConflicts& faceConflicts = v_conflict[face->getId()];
+                int slot = faceSlot[block*numberFaces + f];
+                const std::vector<int>& visible = blockVisible[block*numberFaces + f];
+                for(unsigned int i=0; i<visible.size(); i++, conflict++, slot++){
+                    int point = visible[i];
+                    Conflict& arc     = conflicts[conflict];
+                    arc.point         = point;
+                    arc.face          = face;
+                    arc.prevInVertex  = -1;
+                    arc.nextInVertex  = f_conflict[point];
+                    arc.slotInFace    = slot;
+                    if(arc.nextInVertex != -1){
+                        conflicts[arc.nextInVertex].prevInVertex = conflict;
+                    }else{
+                        blockNewVertex[block]++;
+                    }
+                    f_conflict[point] = conflict;
+                    faceConflicts.points[slot]    = point;
+                    faceConflicts.conflicts[slot] = conflict;
+                }
             }
         }
+    });
 
-    }
+    CH_STATS(if(stats){
+        for(int block=0; block<numberBlocks; block++){
+            stats->exactOrientationTests += blockExactTests[block];
+            stats->vertexWithConflicts   += blockNewVertex[block];
+        }
+        stats->conflictInsertions += blockBegin[numberBlocks] - blockBegin[0];
+        stats->conflicts          += blockBegin[numberBlocks] - blockBegin[0];
+        stats->updatePeaks();
+    });
 }
 
 /**
  * @brief ConflictGraph::isVisible()
- * This method is the used to verify if the vertex see the face
+ * This method is the used to verify if the vertex see the face, using the cached plane of the face
  * @return True if the vertex see the face, false otherwise
  */
-bool ConflictGraph::isVisible(Dcel::Vertex *vertex, Dcel::Face *face) const{
+bool ConflictGraph::isVisible(int point, Dcel::Face *face) const{
+
+    unsigned long long exactTests = 0;
+    bool visible = isVisible(point, face, getFacePlane(face), exactTests);
+    CH_STATS(if(stats){
+        stats->orientationTests++;
+        stats->exactOrientationTests += exactTests;
+    });
+    return visible;
+}
+
+/**
+ * @brief ConflictGraph::isVisible(int point, Dcel::Face *face, const FacePlane &plane, unsigned long long &exactTests)
+ * This method decide the visibility with the plane when the sign of its value is certain, otherwise with
+ * the exact orientation of the point with respect to the vertices of the face (counted in exactTests).
+ * It does not modify the CG, so it can be called by more threads at the same time
+ * @return True if the point is strictly on the positive side of the face, false otherwise
+ */
+bool ConflictGraph::isVisible(int point, Dcel::Face *face, const FacePlane& plane, unsigned long long& exactTests) const{
+
+    //Fuori dal bound dell'errore il segno del piano è quello esatto
+    double value = VisibilityKernels::evaluate(plane, points, point);
+    if(value > plane.errorBound){
+        return true;
+    }
+    if(value < -plane.errorBound){
+        return false;
+    }
+
+    exactTests++;
+    Dcel::HalfEdge* halfEdge = face->getOuterHalfEdge();
+    return Predicates::orient3d(halfEdge->getFromVertex()->getCoordinate(),
+                                halfEdge->getNext()->getFromVertex()->getCoordinate(),
+                                halfEdge->getNext()->getNext()->getFromVertex()->getCoordinate(),
+                                points.getPoint(point)) > 0.0;
+}
+
+/**
+ * @brief ConflictGraph::confirmVisible()
+ * This method keep, between the candidates returned by a kernel, only the points that really see the face
+ * @return the number of points left at the beginning of candidates
+ */
+int ConflictGraph::confirmVisible(Dcel::Face* face, const FacePlane& plane, int* candidates, int numberCandidates, unsigned long long& exactTests) const{
 
-    //Data la faccia ed un vertice, verifico se sono in conflitto
-    Eigen::Matrix<double,4,4> matrix;
-    int k=0;
-    for(Dcel::Face::IncidentVertexIterator vit = face->incidentVertexBegin(); vit != face->incidentVertexEnd(); ++vit,k++){
-        Dcel::Vertex* vertex=*vit;
-        Pointd p= vertex->getCoordinate();
-        matrix(k,0) = p.x();
-        matrix(k,1) = p.y();
-        matrix(k,2) = p.z();
-        matrix(k,3) = 1;
+    int numberVisible = 0;
+    for(int i=0; i<numberCandidates; i++){
+        if(isVisible(candidates[i], face, plane, exactTests)){
+            candidates[numberVisible++] = candidates[i];
+        }
     }
-    Pointd p=vertex->getCoordinate();
-    matrix(3,0) = p.x();
-    matrix(3,1) = p.y();
-    matrix(3,2) = p.z();
-    matrix(3,3) = 1;
-    //Se il det è <0 allora sono in conflitto e quindi si vedono
-    return ((matrix.determinant()) < -std::numeric_limits<double>::epsilon());
+    return numberVisible;
 }
 
 
 
 /**
- * @brief ConflictGraph::addFaceToVertex()
- * This method is the used to insert the face f that is in conflict with the vertex v into the f_conflict
+ * @brief ConflictGraph::addConflict()
+ * This method is the used to insert the arc (point, face) in both f_conflict and v_conflict.
+ * The arc is taken from the free list when possible, so no allocation is done once the pool is warm.
  */
-void ConflictGraph::addFaceToVertex(Dcel::Face* face, Dcel::Vertex* vertex){
+void ConflictGraph::addConflict(int point, Dcel::Face* face){
 
-    auto iter =this->f_conflict.find(vertex);
-    if(iter!=f_conflict.end()){
-        //se esiste gia lo aggiungo
-        std::set<Dcel::Face*>* faceList = f_conflict[vertex];
-        faceList->insert(face);
+    unsigned int faceId = face->getId();
+    if(faceId >= v_conflict.size()){
+        v_conflict.resize(faceId+1);
+    }
+
+    //Prendo un arco libero, altrimenti ne creo uno nuovo in coda
+    int conflict;
+    if(freeConflict != -1){
+        conflict     = freeConflict;
+        freeConflict = conflicts[conflict].nextInVertex;
     }else{
-        //Altrimenti lo creo per la prima volta ed inserisco
-        std::set<Dcel::Face*>* faceList = new std::set<Dcel::Face*>();
-        faceList->insert(face);
-        f_conflict[vertex]=faceList;
+        conflict = conflicts.size();
+        conflicts.push_back(Conflict());
+    }
+
+    CH_STATS(if(stats){
+        stats->conflictInsertions++;
+        stats->conflicts++;
+        if(f_conflict[point] == -1) stats->vertexWithConflicts++;
+        if(v_conflict[faceId].points.empty()) stats->facesWithConflicts++;
+        stats->updatePeaks();
+    });
+
+    //Inserimento in testa alla lista del punto
+    Conflict& arc     = conflicts[conflict];
+    arc.point         = point;
+    arc.face          = face;
+    arc.prevInVertex  = -1;
+    arc.nextInVertex  = f_conflict[point];
+    if(arc.nextInVertex != -1){
+        conflicts[arc.nextInVertex].prevInVertex = conflict;
     }
+    f_conflict[point] = conflict;
+
+    //Inserimento in coda alle liste contigue della faccia
+    FaceConflicts& faceConflicts = v_conflict[faceId];
+    arc.slotInFace = faceConflicts.points.size();
+    faceConflicts.points.push_back(point);
+    faceConflicts.conflicts.push_back(conflict);
 }
 
 /**
- * @brief ConflictGraph::addVertexToFace()
- * This method is the used to insert the vertex v that is in conflict with the face f into the v_conflict
+ * @brief ConflictGraph::unlinkFromVertex()
+ * This method is the used to remove the arc from the list of its point
  */
-void ConflictGraph::addVertexToFace(Dcel::Vertex* vertex,Dcel::Face* face){
+void ConflictGraph::unlinkFromVertex(int conflict){
 
-    auto iter =this->v_conflict.find(face);
-    if(iter!=v_conflict.end()){
-        //Se esiste gia lo aggiungo
-        std::set<Dcel::Vertex*>* vertexList = v_conflict[face];
-        vertexList->insert(vertex);
+    const Conflict& arc = conflicts[conflict];
+    if(arc.prevInVertex != -1){
+        conflicts[arc.prevInVertex].nextInVertex = arc.nextInVertex;
     }else{
-        //altrimenti lo creo nuovo e poi aggiungo
-        std::set<Dcel::Vertex*>* vertexList = new std::set<Dcel::Vertex*>();
-        vertexList->insert(vertex);
-        v_conflict[face]=vertexList;
+        f_conflict[arc.point] = arc.nextInVertex;
+    }
+    if(arc.nextInVertex != -1){
+        conflicts[arc.nextInVertex].prevInVertex = arc.prevInVertex;
     }
+    CH_STATS(if(stats && f_conflict[arc.point] == -1) stats->vertexWithConflicts--);
+}
+
+/**
+ * @brief ConflictGraph::unlinkFromFace()
+ * This method is the used to remove the arc from the lists of its face, with a swap with the last element
+ */
+void ConflictGraph::unlinkFromFace(int conflict){
+
+    FaceConflicts& faceConflicts = v_conflict[conflicts[conflict].face->getId()];
+    int slot = conflicts[conflict].slotInFace;
+    int last = faceConflicts.points.size()-1;
+
+    //Sposto l'ultimo elemento al posto di quello eliminato e ne aggiorno la posizione
+    if(slot != last){
+        faceConflicts.points[slot]    = faceConflicts.points[last];
+        faceConflicts.conflicts[slot] = faceConflicts.conflicts[last];
+        conflicts[faceConflicts.conflicts[slot]].slotInFace = slot;
+    }
+    faceConflicts.points.pop_back();
+    faceConflicts.conflicts.pop_back();
+    CH_STATS(if(stats && faceConflicts.points.empty()) stats->facesWithConflicts--);
+}
+
+/**
+ * @brief ConflictGraph::releaseConflict()
+ * This method is the used to give back the arc to the free list
+ */
+void ConflictGraph::releaseConflict(int conflict){
+
+    conflicts[conflict].face         = nullptr;
+    conflicts[conflict].nextInVertex = freeConflict;
+    freeConflict = conflict;
+    CH_STATS(if(stats){
+        stats->conflictDeletions++;
+        stats->conflicts--;
+    });
 }
 
 /**
  * @brief ConflictGraph::deleteFaces()
  * This method is the used to delete the face f from the vertex v, because the face f is not in conflict
  */
-void ConflictGraph::deleteFaces(std::set<Dcel::Face*> *faces){
+void ConflictGraph::deleteFaces(const std::vector<Dcel::Face*>& faces){
+    CH_TRACE("deleteFaces");
 
     //Per ogni faccia
-    for(std::set<Dcel::Face*>::iterator fit = faces->begin(); fit != faces->end(); ++fit){
+    for(std::vector<Dcel::Face*>::const_iterator fit = faces.begin(); fit != faces.end(); ++fit){
         Dcel::Face* currentFace=*fit;
-        std::set<Dcel::Vertex*>* vertexFromRemoveFace = getVertexVisibleByFace(currentFace);
+        if(currentFace->getId() >= v_conflict.size()){
+            continue;
+        }
+        FaceConflicts& faceConflicts = v_conflict[currentFace->getId()];
 
         //Per ogni vertice che vede la faccia, elimino il riferimento ad essa da f_conflict
-        for(std::set<Dcel::Vertex*>::iterator vit=vertexFromRemoveFace->begin(); vit!= vertexFromRemoveFace->end();++vit){
-            Dcel::Vertex* currentVertex = *vit;
-            f_conflict[currentVertex] -> erase(currentFace);
+        for(std::vector<int>::iterator cit = faceConflicts.conflicts.begin(); cit != faceConflicts.conflicts.end(); ++cit){
+            unlinkFromVertex(*cit);
+            releaseConflict(*cit);
         }
-        //Poi elimino la faccia stessa da v_conflict
-        v_conflict.erase(currentFace);
+        //Poi svuoto la faccia stessa da v_conflict (la capacità resta per la faccia che riuserà l'id)
+        CH_STATS(if(stats && !faceConflicts.points.empty()) stats->facesWithConflicts--);
+        faceConflicts.points.clear();
+        faceConflicts.conflicts.clear();
     }
 }
 
@@ -158,91 +407,157 @@ void ConflictGraph::deleteFaces(std::set<Dcel::Face*> *faces){
  * @brief ConflictGraph::deleteVertexFromFace()
  * This method is the used to delete the vertex v from the face f, because the vertex v is not in conflict
  */
-void ConflictGraph::deleteVertex(Dcel::Vertex* vertex){
+void ConflictGraph::deleteVertex(int point){
 
-    std::set<Dcel::Face*>* facesToRemoveVertex = getFacesVisibleByVertex(vertex);
     //Elimo i riferimenti al vertice dalla facce chee vede il vertice
-    for(std::set<Dcel::Face*>::iterator fit = facesToRemoveVertex->begin(); fit != facesToRemoveVertex->end(); ++fit){
-        Dcel::Face* currentFace=*fit;
-        v_conflict[currentFace]->erase(vertex);
+    int conflict = f_conflict[point];
+    CH_STATS(if(stats && conflict != -1) stats->vertexWithConflicts--);
+    while(conflict != -1){
+        int next = conflicts[conflict].nextInVertex;
+        unlinkFromFace(conflict);
+        releaseConflict(conflict);
+        conflict = next;
     }
     //elimino il vertice stesso
-    f_conflict.erase(vertex);
+    f_conflict[point] = -1;
 }
 
 
 /**
  * @brief ConflictGraph::getFacesVisibleByVertex()
  * This method return the faces that are in conflict with vertex
- * @return set<Dcel::Face *>* at the visible faces of the vertex
+ * @return a view of the visible faces of the vertex, valid until the CG is modified
  */
-std::set<Dcel::Face *>* ConflictGraph::getFacesVisibleByVertex(Dcel::Vertex *vertex) const{
+ConflictGraph::FacesView ConflictGraph::getFacesVisibleByVertex(int point) const{
 
-    auto iter =this->f_conflict.find(vertex);
-    if(iter!=f_conflict.end()){
-        return new std::set<Dcel::Face*>(*f_conflict.at(vertex));
-    }else{
-        return new std::set<Dcel::Face*>();
-    }
+    return FacesView(&conflicts, f_conflict[point]);
 }
 
 /**
  * @brief ConflictGraph::getVertexVisibleByFace()
  * This method return the vertexs that are in conflict with the face f
- * @return set<Dcel::Face *>* at the vertexs visible by the face
+ * @return a view of the indices of the vertexs visible by the face, valid until the CG is modified
  */
-std::set<Dcel::Vertex *>* ConflictGraph::getVertexVisibleByFace(Dcel::Face *face) const{
+ConflictGraph::VertexView ConflictGraph::getVertexVisibleByFace(Dcel::Face *face) const{
 
-    auto iter =this->v_conflict.find(face);
-    if(iter!=v_conflict.end()){
-        return new std::set<Dcel::Vertex *>(*v_conflict.at(face));
+    if(face->getId() < v_conflict.size()){
+        const std::vector<int>& points = v_conflict[face->getId()].points;
+        return VertexView(points.data(), points.data()+points.size());
     }else{
-        return new std::set<Dcel::Vertex *>();
+        return VertexView(nullptr, nullptr);
     }
 }
 
 
 /**
  * @brief ConflictGraph::UpdateCG()
- * This method return the vertexs that are in conflict with the face f
+ * This method compute the plane of the new face f and add to the CG the vertexs, between the candidates,
+ * that are in conflict with it
  */
-void ConflictGraph::updateCG(Dcel::Face* faceToUpdate,std::set<Dcel::Vertex*>* setVertexForFace){
+void ConflictGraph::updateCG(Dcel::Face* faceToUpdate, VertexView vertexForFace){
+
+    //La faccia è nuova, ne calcolo il piano una volta sola
+    const FacePlane& plane = computePlane(faceToUpdate);
+
+    //Classifico tutti i vertici candidati con il kernel, scarto quelli certamente dietro la faccia e aggiungo al cg
+    //quelli che la vedono (il predicato esatto decide solo i casi incerti)
+    int numberCandidates = vertexForFace.size();
+    visibleBuffer.resize(numberCandidates);
+    unsigned long long exactTests = 0;
+    int numberVisible = VisibilityKernels::classifyIndices(plane, points, vertexForFace.begin(), numberCandidates, -plane.errorBound, visibleBuffer.data());
+    numberVisible = confirmVisible(faceToUpdate, plane, visibleBuffer.data(), numberVisible, exactTests);
+    CH_STATS(if(stats){
+        stats->orientationTests      += numberCandidates;
+        stats->exactOrientationTests += exactTests;
+    });
+    for(int i=0; i<numberVisible; i++){
+        addConflict( visibleBuffer[i], faceToUpdate );
+    }
+}
 
-    //Scorro il set dei vertici
-    for(std::set<Dcel::Vertex*>::iterator vit= setVertexForFace->begin(); vit != setVertexForFace->end(); ++vit){
-        Dcel::Vertex* currentVertex = *vit;
-        //Se il vertice è visibile dalla faccia allora lo aggiungo al cg
-        if(isVisible(currentVertex, faceToUpdate)){
-            addFaceToVertex( faceToUpdate, currentVertex );
-            addVertexToFace( currentVertex, faceToUpdate );
+/**
+ * @brief ConflictGraph::UpdateCG(const std::vector<Dcel::Face*>& newFaces, const std::vector<int>& vertexToControl, const std::vector<int>& offsets)
+ * This method update the CG with all the new faces of a step, the candidates of the i-th face are
+ * vertexToControl[offsets[i]..offsets[i+1]). If there are enough candidates the faces are classified in
+ * parallel, each in its own buffer; then the arcs are added by the calling thread, in the order of the faces
+ */
+void ConflictGraph::updateCG(const std::vector<Dcel::Face*>& newFaces, const std::vector<int>& vertexToControl, const std::vector<int>& offsets){
+    CH_TRACE("updateCG");
+
+    //Prima calcolo tutti i piani, il vettore dei piani può crescere e non deve farlo mentre i thread lo leggono
+    int numberFaces = newFaces.size();
+    for(int i=0; i<numberFaces; i++){
+        computePlane(newFaces[i]);
+    }
+    if((int) newFacesBuffers.size() < numberFaces){
+        newFacesBuffers.resize(numberFaces);
+    }
+    newFacesExactTests.assign(numberFaces, 0);
+    ThreadPool::RangeTask classify = [&](int firstFace, int lastFace){
+        CH_TRACE("classifyNewFaces");
+        for(int i=firstFace; i<lastFace; i++){
+            const FacePlane& plane = planes[newFaces[i]->getId()];
+            int numberCandidates = offsets[i+1] - offsets[i];
+            std::vector<int>& visible = newFacesBuffers[i];
+            visible.resize(numberCandidates);
+            int numberVisible = VisibilityKernels::classifyIndices(plane, points, vertexToControl.data()+offsets[i], numberCandidates, -plane.errorBound, visible.data());
+            visible.resize(confirmVisible(newFaces[i], plane, visible.data(), numberVisible, newFacesExactTests[i]));
+        }
+    };
+    if(threadPool != nullptr && threadPool->getNumberThreads() > 1 && offsets[numberFaces] >= PARALLEL_GRAIN){
+        threadPool->parallelFor(0, numberFaces, 1, classify);
+    }else{
+        classify(0, numberFaces);
+    }
+
+    CH_STATS(if(stats) stats->orientationTests += offsets[numberFaces]);
+    for(int i=0; i<numberFaces; i++){
+        CH_STATS(if(stats) stats->exactOrientationTests += newFacesExactTests[i]);
+        const std::vector<int>& visible = newFacesBuffers[i];
+        for(unsigned int j=0; j<visible.size(); j++){
+            addConflict( visible[j], newFaces[i] );
         }
     }
 }
 
 /**
- * @brief ConflictGraph::getVertexMapToControlForTheNewFace()
- * This method is used to get the vertex that can be in conflict with the new Faces
- * @return map<Dcel::HalfEdge *, std::set<Dcel::Vertex*> *>
+ * @brief ConflictGraph::getVertexToControlForTheNewFaces()
+ * This method is used to get the vertex that can be in conflict with the new Faces.
+ * The candidates of the i-th half edge of the horizon are vertexToControl[offsets[i]..offsets[i+1]),
+ * both buffers are reused between the calls.
  */
-std::map<Dcel::HalfEdge *, std::set<Dcel::Vertex*> *> ConflictGraph::getVertexMapToControlForTheNewFace(std::list<Dcel::HalfEdge *> horizon) const{
+void ConflictGraph::getVertexToControlForTheNewFaces(const std::vector<Dcel::HalfEdge*>& horizon, std::vector<int>& vertexToControl, std::vector<int>& offsets){
+    CH_TRACE("getVertexToControlForTheNewFaces");
 
-    std::map<Dcel::HalfEdge *, std::set<Dcel::Vertex*>*> vertexMap;
+    vertexToControl.clear();
+    offsets.clear();
+    offsets.push_back(0);
 
     //Scorro l'orizzonte, e per ogni half edge dell'orizzonte prendo i vertici in conflitto con la faccia dell'half edge considerato
-    //e del suo twin e lo associo all'half edge dell'orizzonte
-    for(std::list<Dcel::HalfEdge*>::iterator hit = horizon.begin(); hit != horizon.end(); ++hit){
+    //e del suo twin e li accodo, i marcatori evitano i duplicati senza dover costruire un set
+    for(std::vector<Dcel::HalfEdge*>::const_iterator hit = horizon.begin(); hit != horizon.end(); ++hit){
         Dcel::HalfEdge* currentHalfEdge = *hit;
-        std::set<Dcel::Vertex*>* unionVertex= new std::set<Dcel::Vertex*>();
 
-        std::set<Dcel::Vertex*>* vertexFaceHorizon     = getVertexVisibleByFace(currentHalfEdge->getFace());
-        std::set<Dcel::Vertex*>* vertexFaceTwinHorizon = getVertexVisibleByFace(currentHalfEdge->getTwin()->getFace());
+        if(++markEpoch == 0){
+            std::fill(vertexMark.begin(), vertexMark.end(), 0);
+            markEpoch = 1;
+        }
+
+        VertexView vertexFaceHorizon     = getVertexVisibleByFace(currentHalfEdge->getFace());
+        VertexView vertexFaceTwinHorizon = getVertexVisibleByFace(currentHalfEdge->getTwin()->getFace());
 
         //Inserisco i vertici delle due facce
-        unionVertex->insert(vertexFaceHorizon->begin(),         vertexFaceHorizon->end());
-        unionVertex->insert(vertexFaceTwinHorizon->begin(), vertexFaceTwinHorizon->end());
-        vertexMap[currentHalfEdge] = unionVertex;
+        for(const int* vit = vertexFaceHorizon.begin(); vit != vertexFaceHorizon.end(); ++vit){
+            vertexMark[*vit] = markEpoch;
+            vertexToControl.push_back(*vit);
+        }
+        for(const int* vit = vertexFaceTwinHorizon.begin(); vit != vertexFaceTwinHorizon.end(); ++vit){
+            if(vertexMark[*vit] != markEpoch){
+                vertexToControl.push_back(*vit);
+            }
+        }
+        offsets.push_back(vertexToControl.size());
     }
-    return vertexMap;
 }
 
 /*********************************************************************
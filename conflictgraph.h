@@ -1,33 +1,90 @@
 #ifndef CONFLICTGRAPH_H
 #define CONFLICTGRAPH_H
 
-#include <eigen3/Eigen/Dense>
-#include "GUI/managers/dcelmanager.h"
-#include "lib/dcel/drawable_dcel.h"
+#include "lib/dcel/dcel.h"
+#include "convexhullstats.h"
+#include "convexhulltrace.h"
+#include "pointbuffer.h"
+#include "predicates.h"
+#include "threadpool.h"
+#include "visibilitykernels.h"
+#include <iterator>
+#include <vector>
 
 
 
 class ConflictGraph{
 
 public:
-    //metodi
-    ConflictGraph(DrawableDcel* dcel,const std::vector<Dcel::Vertex*> &vertexS, const int numberVertex);
-    void initializeCG();
-    bool isVisible(Dcel::Vertex* vertex,Dcel::Face* face) const;
-    std::set<Dcel::Face*>* getFacesVisibleByVertex(Dcel::Vertex* vertex) const;
-    std::set<Dcel::Vertex*>* getVertexVisibleByFace(Dcel::Face* face) const;
-    void deleteVertex(Dcel::Vertex* vertex);
-    void deleteFaces(std::set<Dcel::Face*>* faces);
-    void updateCG(Dcel::Face* faceToUpdate, std::set<Dcel::Vertex*>* setVertexForFace);
-    std::map<Dcel::HalfEdge*, std::set<Dcel::Vertex*>*> getVertexMapToControlForTheNewFace(std::list<Dcel::HalfEdge*> horizon) const;
+    //Arco del conflict graph: il punto (indice in vertexS e nel PointBuffer) vede la faccia
+    struct Conflict{
+        int         point;
+        Dcel::Face* face;
+        int         prevInVertex;
+        int         nextInVertex;
+        int         slotInFace;
+    };
+
+    //Vista (non proprietaria) delle facce in conflitto con un punto. Resta valida finchè il CG non viene modificato
+    class FacesView{
+    public:
+        class iterator{
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Dcel::Face*               value_type;
+            typedef std::ptrdiff_t            difference_type;
+            typedef Dcel::Face* const*        pointer;
+            typedef Dcel::Face*               reference;
 
+            iterator(const std::vector<Conflict>* conflicts, int current) : conflicts(conflicts), current(current){}
+            Dcel::Face* operator*() const { return (*conflicts)[current].face; }
+            iterator& operator++() { current = (*conflicts)[current].nextInVertex; return *this; }
+            bool operator==(const iterator& other) const { return current == other.current; }
+            bool operator!=(const iterator& other) const { return current != other.current; }
+        private:
+            const std::vector<Conflict>* conflicts;
+            int current;
+        };
 
+        FacesView(const std::vector<Conflict>* conflicts, int head) : conflicts(conflicts), head(head){}
+        iterator begin() const { return iterator(conflicts, head); }
+        iterator end()   const { return iterator(conflicts, -1); }
+        bool empty()     const { return head == -1; }
+    private:
+        const std::vector<Conflict>* conflicts;
+        int head;
+    };
 
-    //OggettiVariali creati in questa classe
-    //HO usato una mappa di set, vista l'esigenza di eliminare ed aggiornare spesso. Questa è la soluzione migliore rispetto all'utilizzo di
-    //vettore che è poco dinamico. Ad esempio per eliminare un oggetto bisogna successivmente risistemare tutti gli elementi del vettore.
-    std::map<Dcel::Face*, std::set<Dcel::Vertex*>*> v_conflict;
-    std::map<Dcel::Vertex*, std::set<Dcel::Face*>*> f_conflict;
+    //Vista (non proprietaria) dei punti in conflitto con una faccia, memorizzati in modo contiguo
+    class VertexView{
+    public:
+        VertexView(const int* first, const int* last) : first(first), last(last){}
+        const int* begin() const { return first; }
+        const int* end()   const { return last; }
+        size_t size()      const { return last - first; }
+        bool empty()       const { return first == last; }
+        int operator[](size_t i) const { return first[i]; }
+    private:
+        const int* first;
+        const int* last;
+    };
+
+    //Numero minimo di test di visibilità per cui conviene dividere il lavoro tra i thread
+    static const int PARALLEL_GRAIN = 16384;
+
+    //metodi
+    ConflictGraph(Dcel* dcel,const PointBuffer &points, ConvexHullStats* stats = nullptr);
+    void setThreadPool(ThreadPool* threadPool);
+    void initializeCG();
+    bool isVisible(int point,Dcel::Face* face) const;
+    FacesView getFacesVisibleByVertex(int point) const;
+    VertexView getVertexVisibleByFace(Dcel::Face* face) const;
+    void deleteVertex(int point);
+    void deleteFaces(const std::vector<Dcel::Face*>& faces);
+    void updateCG(Dcel::Face* faceToUpdate, VertexView vertexForFace);
+    void updateCG(const std::vector<Dcel::Face*>& newFaces, const std::vector<int>& vertexToControl, const std::vector<int>& offsets);
+    const FacePlane& getFacePlane(Dcel::Face* face) const;
+    void getVertexToControlForTheNewFaces(const std::vector<Dcel::HalfEdge*>& horizon, std::vector<int>& vertexToControl, std::vector<int>& offsets);
 
 
 
@@ -36,12 +93,47 @@ private:
     const int numberVertex;
 
     //Oggetti-Variabili passati da convexhull core
-    DrawableDcel* dcel;
-    std::vector<Dcel::Vertex*> vertexS;
+    Dcel* dcel;
+    const PointBuffer& points;
+    ConvexHullStats* stats;
+    ThreadPool* threadPool;
+
+    //Liste di conflitti contigue per faccia (indicizzate con l'id della faccia nella dcel)
+    struct FaceConflicts{
+        std::vector<int> points;
+        std::vector<int> conflicts;
+    };
+
+    //Gli archi sono in un unico vettore, le celle liberate vengono riusate tramite una free list. Ogni punto ha la testa
+    //della sua lista di archi (f_conflict), ogni faccia ha le sue liste contigue (v_conflict); la rimozione è sempre O(1)
+    std::vector<Conflict>      conflicts;
+    int                        freeConflict;
+    std::vector<FaceConflicts> v_conflict;
+    std::vector<int>           f_conflict;
+
+    //Piani delle facce (indicizzati con l'id della faccia), calcolati una sola volta quando la faccia entra nel CG
+    std::vector<FacePlane>     planes;
+
+    //Buffer in cui i kernel scrivono i punti visibili da una faccia (uno per ogni nuova faccia, così le facce
+    //possono essere classificate in parallelo)
+    std::vector<int>           visibleBuffer;
+    std::vector<std::vector<int> > newFacesBuffers;
+    //Test esatti di ogni nuova faccia, sommati alle statistiche dopo la classificazione parallela
+    std::vector<unsigned long long> newFacesExactTests;
+
+    //Marcatori usati per unire senza duplicati i punti di due facce
+    std::vector<unsigned int>  vertexMark;
+    unsigned int               markEpoch;
 
-    //Metodi privati usati per aggiungere gli elementi su v_conflict ed f_conflict
-    void addFaceToVertex(Dcel::Face* face, Dcel::Vertex* vertex);
-    void addVertexToFace(Dcel::Vertex* vertex, Dcel::Face* face);
+    //Metodi privati usati per aggiungere e rimuovere gli archi su v_conflict ed f_conflict
+    void addConflict(int point, Dcel::Face* face);
+    void unlinkFromVertex(int conflict);
+    void unlinkFromFace(int conflict);
+    void releaseConflict(int conflict);
+    const FacePlane& computePlane(Dcel::Face* face);
+    bool isVisible(int point, Dcel::Face* face, const FacePlane& plane, unsigned long long& exactTests) const;
+    int confirmVisible(Dcel::Face* face, const FacePlane& plane, int* candidates, int numberCandidates, unsigned long long& exactTests) const;
+    void initializeCGParallel(const std::vector<Dcel::Face*>& faces);
 
 };
 
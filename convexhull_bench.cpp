@@ -0,0 +1,285 @@
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Benchmark del convex hull: genera nuvole di punti riproducibili   *
+ * (seed fisso) con diverse distribuzioni, le passa all'algoritmo e  *
+ * stampa in CSV tempo reale, punti al secondo e picco di memoria    *
+ * (RSS) per ogni fase di findConvexHull(). Il picco viene azzerato  *
+ * all'inizio di ogni fase solo su linux (/proc/self/clear_refs),    *
+ * altrove è il picco dall'inizio del processo.                      *
+ *                                                                   *
+ * Uso: ConvexHullBench [--dist cube,ball,sphere,gaussian,clustered] *
+ *                      [--sizes 1000,10000,...] [--seed s]          *
+ *                      [--reps r] [--threads t]                     *
+ *                      [--strategy incremental|divide|quickhull]    *
+ *                      [--cull] [--order random|brio]               *
+ *********************************************************************/
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include "GUI/ConvexHullCore/convexhullcore.h"
+
+#ifdef __unix__
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief resetPeakRss()
+ * This function reset the peak resident set size of the process to the current one, so the next peakRssKb() is the
+ * peak of the phase that starts now. It is possible only on linux (writing 5 in /proc/self/clear_refs)
+ * @return True if the peak was reset, false otherwise
+ */
+static bool resetPeakRss(){
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+    return !clearRefs.fail();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief peakRssKb()
+ * This function return the peak resident set size in KB since the last resetPeakRss() (VmHWM on linux), or since
+ * the start of the process if it can not be reset (0 if not available)
+ */
+static long peakRssKb(){
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line)){
+        if(line.compare(0, 6, "VmHWM:") == 0){
+            return std::atol(line.c_str() + 6);
+        }
+    }
+#endif
+#ifdef __unix__
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; //su linux è già in KB
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief generatePoints()
+ * This function generate n points with the given distribution, the sequence depends only on the seed
+ * @return false if the distribution is unknown
+ */
+static bool generatePoints(const std::string& distribution, int n, unsigned int seed, std::vector<Pointd>& points){
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    points.clear();
+    points.reserve(n);
+
+    if(distribution == "cube"){
+        for(int i=0; i<n; i++){
+            points.push_back(Pointd(uniform(rng), uniform(rng), uniform(rng)));
+        }
+    }else if(distribution == "ball"){
+        //Rejection sampling dal cubo
+        while((int)points.size() < n){
+            double x = uniform(rng), y = uniform(rng), z = uniform(rng);
+            if(x*x + y*y + z*z <= 1.0){
+                points.push_back(Pointd(x, y, z));
+            }
+        }
+    }else if(distribution == "sphere"){
+        //Caso peggiore: tutti i punti stanno sul convex hull
+        while((int)points.size() < n){
+            double x = normal(rng), y = normal(rng), z = normal(rng);
+            double length = std::sqrt(x*x + y*y + z*z);
+            if(length > 0){
+                points.push_back(Pointd(x/length, y/length, z/length));
+            }
+        }
+    }else if(distribution == "gaussian"){
+        for(int i=0; i<n; i++){
+            points.push_back(Pointd(normal(rng), normal(rng), normal(rng)));
+        }
+    }else if(distribution == "clustered"){
+        //16 cluster gaussiani con centri uniformi nel cubo
+        const int numberClusters = 16;
+        std::vector<Pointd> centers;
+        for(int i=0; i<numberClusters; i++){
+            centers.push_back(Pointd(uniform(rng), uniform(rng), uniform(rng)));
+        }
+        std::uniform_int_distribution<int> pick(0, numberClusters-1);
+        for(int i=0; i<n; i++){
+            const Pointd& c = centers[pick(rng)];
+            points.push_back(Pointd(c.x() + 0.05*normal(rng), c.y() + 0.05*normal(rng), c.z() + 0.05*normal(rng)));
+        }
+    }else{
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief split()
+ * This function split a comma separated list
+ */
+static std::vector<std::string> split(const std::string& list){
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while(std::getline(ss, item, ',')){
+        if(!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+/**
+ * @brief runBenchmark()
+ * This function generate the points, compute the convex hull and print a CSV row for every phase
+ */
+static int runBenchmark(const std::string& distribution, int n, unsigned int seed, int rep, int threads, ConvexHullCore::Strategy strategy, bool cull, ConvexHullCore::InsertionOrder order){
+
+    typedef std::chrono::steady_clock Clock;
+    std::ostringstream out;
+
+    Clock::time_point start = Clock::now();
+    std::vector<Pointd> points;
+    if(!generatePoints(distribution, n, seed, points)){
+        std::cerr << "Unknown distribution: " << distribution << std::endl;
+        return 1;
+    }
+
+    //Stampa una riga CSV per la fase appena conclusa, con il picco di memoria della fase: dopo ogni riga il picco
+    //riparte dalla memoria corrente. La riga "total" ha il picco massimo tra le fasi dell'algoritmo
+    Clock::time_point phaseStart = Clock::now();
+    long totalPeakRss = 0;
+    auto printPhase = [&](const char* phase, Clock::time_point begin, Clock::time_point end, long peakRss){
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        out << distribution << "," << n << "," << seed << "," << rep << "," << phase << ","
+            << seconds << "," << (seconds > 0 ? n / seconds : 0) << "," << peakRss << "\n";
+    };
+    printPhase("generate", start, phaseStart, peakRssKb());
+    bool perPhasePeak = resetPeakRss();
+    if(!perPhasePeak){
+        std::cerr << "Cannot reset the peak RSS: peak_rss_kb is the peak since the start of the process" << std::endl;
+    }
+
+    Dcel dcel;
+    ConvexHullCore convexHullCore(points.data(), n, &dcel);
+    convexHullCore.setNumberThreads(threads);
+    convexHullCore.setStrategy(strategy);
+    convexHullCore.setInteriorCulling(cull);
+    convexHullCore.setInsertionOrder(order);
+    convexHullCore.setPhaseCallback([&](const char* phase){
+        Clock::time_point now = Clock::now();
+        long peakRss = peakRssKb();
+        totalPeakRss = std::max(totalPeakRss, peakRss);
+        printPhase(phase, phaseStart, now, peakRss);
+        resetPeakRss();
+        phaseStart = Clock::now();
+    });
+
+    //Stesso seed anche per la permutazione, così ogni run è riproducibile
+    convexHullCore.setRandomSeed(seed);
+    Clock::time_point hullStart = Clock::now();
+    convexHullCore.findConvexHull();
+    Clock::time_point hullEnd = Clock::now();
+    totalPeakRss = std::max(totalPeakRss, peakRssKb());
+    printPhase("total", hullStart, hullEnd, perPhasePeak ? totalPeakRss : peakRssKb());
+
+    std::cout << out.str();
+    std::cout.flush();
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+
+    std::vector<std::string> distributions = split("cube,ball,sphere,gaussian,clustered");
+    std::vector<std::string> sizes = split("1000,10000,100000,1000000,10000000");
+    unsigned int seed = 1;
+    int reps = 1;
+    int threads = 1;
+    ConvexHullCore::Strategy strategy = ConvexHullCore::INCREMENTAL;
+    bool cull = false;
+    ConvexHullCore::InsertionOrder order = ConvexHullCore::RANDOM_ORDER;
+
+    for(int i=1; i<argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--dist" && i+1 < argc){
+            distributions = split(argv[++i]);
+        }else if(arg == "--sizes" && i+1 < argc){
+            sizes = split(argv[++i]);
+        }else if(arg == "--seed" && i+1 < argc){
+            seed = std::strtoul(argv[++i], nullptr, 10);
+        }else if(arg == "--reps" && i+1 < argc){
+            reps = std::atoi(argv[++i]);
+        }else if(arg == "--threads" && i+1 < argc){
+            threads = std::atoi(argv[++i]);
+        }else if(arg == "--strategy" && i+1 < argc && std::string(argv[i+1]) == "incremental"){
+            strategy = ConvexHullCore::INCREMENTAL;
+            i++;
+        }else if(arg == "--strategy" && i+1 < argc && std::string(argv[i+1]) == "divide"){
+            strategy = ConvexHullCore::PARALLEL_DIVIDE_AND_CONQUER;
+            i++;
+        }else if(arg == "--strategy" && i+1 < argc && std::string(argv[i+1]) == "quickhull"){
+            strategy = ConvexHullCore::QUICKHULL;
+            i++;
+        }else if(arg == "--cull"){
+            cull = true;
+        }else if(arg == "--order" && i+1 < argc && std::string(argv[i+1]) == "random"){
+            order = ConvexHullCore::RANDOM_ORDER;
+            i++;
+        }else if(arg == "--order" && i+1 < argc && std::string(argv[i+1]) == "brio"){
+            order = ConvexHullCore::BRIO_ORDER;
+            i++;
+        }else{
+            std::cerr << "Usage: " << argv[0] << " [--dist cube,ball,sphere,gaussian,clustered]"
+                      << " [--sizes 1000,10000,...] [--seed s] [--reps r] [--threads t]"
+                      << " [--strategy incremental|divide|quickhull] [--cull] [--order random|brio]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "distribution,points,seed,rep,phase,wall_seconds,points_per_second,peak_rss_kb" << std::endl;
+
+    for(unsigned int d=0; d<distributions.size(); d++){
+        for(unsigned int s=0; s<sizes.size(); s++){
+            int n = std::atoi(sizes[s].c_str());
+            if(n < 4){
+                std::cerr << "Skipping size " << sizes[s] << ": at least 4 points are needed" << std::endl;
+                continue;
+            }
+            for(int rep=0; rep<reps; rep++){
+#ifdef __unix__
+                //Ogni run in un processo separato, così il picco di RSS è quello della singola run
+                pid_t pid = fork();
+                if(pid == 0){
+                    _exit(runBenchmark(distributions[d], n, seed + rep, rep, threads, strategy, cull, order));
+                }
+                int status = 0;
+                waitpid(pid, &status, 0);
+                if(!WIFEXITED(status) || WEXITSTATUS(status) != 0){
+                    return 1;
+                }
+#else
+                if(runBenchmark(distributions[d], n, seed + rep, rep, threads, strategy, cull, order) != 0){
+                    return 1;
+                }
+#endif
+            }
+        }
+    }
+    return 0;
+}
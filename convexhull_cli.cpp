@@ -0,0 +1,274 @@
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Driver a riga di comando: carica la mesh (o la nuvola di punti)   *
+ * da un file OBJ, PLY, DCEL o binario, calcola il convex hull senza *
+ * alcuna interfaccia grafica e lo salva sul file di output.         *
+ *                                                                   *
+ * Uso: ConvexHullCli input.{obj,ply,dcel,xyzb} output.{obj,ply,dcel}*
+ *                                                                   *
+ * Con --stream i punti di un file OBJ, di testo (x y z per riga) o  *
+ * binario vengono letti a blocchi senza caricare tutta la nuvola:   *
+ *      ConvexHullCli --stream input.{obj,xyz,xyzb}                  *
+ *                             output.{obj,ply,dcel}                 *
+ *                                                                   *
+ * I file binari (.xyzb, vedi PointCloudFile) vengono mappati in     *
+ * memoria; --convert li crea dai vertici di un file OBJ, PLY o DCEL *
+ * (in float con --float):                                           *
+ *      ConvexHullCli --convert input.{obj,ply,dcel} output.xyzb     *
+ *                                                                   *
+ * Con --log la costruzione viene registrata (vedi ConvexHullLog) e  *
+ * --replay salva il convex hull dopo un passo qualsiasi del log,    *
+ * senza ricalcolarlo:                                               *
+ *      ConvexHullCli --log steps.chlog input output                 *
+ *      ConvexHullCli --replay steps.chlog step output.{obj,ply,dcel}*
+ *                                                                   *
+ * Con --trace le fasi dell'algoritmo vengono salvate nel formato di *
+ * Chrome (vedi ConvexHullTrace, serve CONVEXHULL_TRACE):            *
+ *      ConvexHullCli --trace trace.json input output                *
+ *********************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "GUI/ConvexHullCore/convexhullcore.h"
+#include "GUI/ConvexHullCore/convexhullplayer.h"
+#include "GUI/ConvexHullCore/convexhullstream.h"
+#include "GUI/ConvexHullCore/convexhulltrace.h"
+#include "GUI/ConvexHullCore/pointcloudfile.h"
+
+/**
+ * @brief extensionOf()
+ * This function return the extension of the file name (without the dot)
+ */
+static std::string extensionOf(const std::string& filename){
+    size_t dot = filename.find_last_of(".");
+    if(dot == std::string::npos){
+        return "";
+    }
+    return filename.substr(dot + 1);
+}
+
+/**
+ * @brief loadDcel()
+ * This function load the input file into the dcel, choosing the loader by the extension
+ * @return True if the file was loaded, false otherwise
+ */
+static bool loadDcel(Dcel& dcel, const std::string& filename){
+
+    //I loader della dcel non segnalano il file mancante, lo controllo prima
+    std::ifstream file(filename.c_str());
+    if(!file.is_open()){
+        std::cerr << "Cannot open " << filename << std::endl;
+        return false;
+    }
+    file.close();
+
+    std::string extension = extensionOf(filename);
+    if(extension == "obj"){
+        dcel.loadFromObjFile(filename);
+    }else if(extension == "ply"){
+        dcel.loadFromPlyFile(filename);
+    }else if(extension == "dcel"){
+        dcel.loadFromDcelFile(filename);
+    }else{
+        std::cerr << "Unknown input format: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief saveDcel()
+ * This function save the dcel on the output file, choosing the format by the extension
+ * @return True if the format is supported, false otherwise
+ */
+static bool saveDcel(const Dcel& dcel, const std::string& filename){
+
+    std::string extension = extensionOf(filename);
+    if(extension == "obj"){
+        dcel.saveOnObjFile(filename);
+    }else if(extension == "ply"){
+        dcel.saveOnPlyFile(filename);
+    }else if(extension == "dcel"){
+        dcel.saveOnDcelFile(filename);
+    }else{
+        std::cerr << "Unknown output format: " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief streamConvexHull()
+ * This function compute the convex hull of the points of the file reading them one block at a time
+ * @return True if the file was read, false otherwise
+ */
+static bool streamConvexHull(Dcel& dcel, const std::string& filename){
+
+    ConvexHullStream convexHullStream(&dcel);
+    if(!convexHullStream.addFile(filename)){
+        std::cerr << "Cannot open " << filename << std::endl;
+        return false;
+    }
+    if(convexHullStream.getNumberPoints() == 0){
+        std::cerr << filename << " has no points" << std::endl;
+        return false;
+    }
+    std::cout << "Points: " << convexHullStream.getNumberPoints() << "; discarded by the filter: "
+              << convexHullStream.getNumberDiscardedPoints() << "." << std::endl;
+    return true;
+}
+
+/**
+ * @brief convertToPointCloud()
+ * This function write the vertices of the input file in a binary point cloud file
+ * @return True if the file was converted, false otherwise
+ */
+static bool convertToPointCloud(const std::string& input, const std::string& output, bool singlePrecision){
+
+    Dcel dcel;
+    if(!loadDcel(dcel, input)){
+        return false;
+    }
+    if(!PointCloudFile::save(output, dcel, singlePrecision)){
+        std::cerr << "Cannot write " << output << std::endl;
+        return false;
+    }
+    std::cout << "Points: " << dcel.getNumberVertices() << "." << std::endl;
+    return true;
+}
+
+/**
+ * @brief replayLog()
+ * This function save the convex hull after the given step of the log (the final one if step is negative)
+ * @return True if the log was read and the convex hull saved, false otherwise
+ */
+static bool replayLog(const std::string& filename, int step, const std::string& output){
+
+    ConvexHullLog insertionLog;
+    if(!insertionLog.load(filename)){
+        std::cerr << "Cannot read " << filename << std::endl;
+        return false;
+    }
+    ConvexHullPlayer player(insertionLog);
+    player.seek(step < 0 ? player.getNumberSteps() : step);
+
+    ConvexHullCore::Mesh mesh;
+    player.getMesh(mesh, ConvexHullCore::MESH_ADJACENCY);
+    Dcel dcel;
+    ConvexHullCore::meshToDcel(mesh, dcel);
+    if(!saveDcel(dcel, output)){
+        return false;
+    }
+    std::cout << "Step " << player.getStep() << " of " << player.getNumberSteps() << "; Vertices: " << dcel.getNumberVertices()
+              << "; Faces: " << dcel.getNumberFaces() << "." << std::endl;
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+
+    if((argc == 4 || argc == 5) && std::string(argv[1]) == "--convert"){
+        bool singlePrecision = argc == 5 && std::string(argv[4]) == "--float";
+        if(argc == 5 && !singlePrecision){
+            std::cerr << "Unknown option: " << argv[4] << std::endl;
+            return 1;
+        }
+        return convertToPointCloud(argv[2], argv[3], singlePrecision) ? 0 : 1;
+    }
+
+    if(argc == 4 && std::string(argv[1]) == "--stream"){
+        Dcel dcel;
+        if(!streamConvexHull(dcel, argv[2]) || !saveDcel(dcel, argv[3])){
+            return 1;
+        }
+        std::cout << "Vertices: " << dcel.getNumberVertices() << "; Half Edges: " << dcel.getNumberHalfEdges()
+                  << "; Faces: " << dcel.getNumberFaces() << "." << std::endl;
+        return 0;
+    }
+
+    if(argc == 5 && std::string(argv[1]) == "--replay"){
+        return replayLog(argv[2], std::atoi(argv[3]), argv[4]) ? 0 : 1;
+    }
+
+    //--log e --trace (con il loro file) precedono input e output, che restano negli stessi argomenti
+    std::string logFilename, traceFilename;
+    while(argc >= 5 && (std::string(argv[1]) == "--log" || std::string(argv[1]) == "--trace")){
+        (std::string(argv[1]) == "--log" ? logFilename : traceFilename) = argv[2];
+        argv += 2;
+        argc -= 2;
+    }
+
+    if(argc != 3){
+        std::cerr << "Usage: " << argv[0] << " [--stream] input.{obj,ply,dcel,xyzb} output.{obj,ply,dcel}" << std::endl;
+        std::cerr << "       " << argv[0] << " --convert input.{obj,ply,dcel} output.xyzb [--float]" << std::endl;
+        std::cerr << "       " << argv[0] << " --log steps.chlog input.{obj,ply,dcel,xyzb} output.{obj,ply,dcel}" << std::endl;
+        std::cerr << "       " << argv[0] << " --replay steps.chlog step output.{obj,ply,dcel}" << std::endl;
+        std::cerr << "       " << argv[0] << " --trace trace.json input.{obj,ply,dcel,xyzb} output.{obj,ply,dcel}" << std::endl;
+        return 1;
+    }
+
+    //Un file binario viene mappato e letto direttamente dal convex hull, gli altri vengono caricati nella dcel
+    Dcel dcel;
+    PointCloudFile pointCloud;
+    bool isPointCloud = extensionOf(argv[1]) == PointCloudFile::EXTENSION;
+    if(isPointCloud){
+        if(!pointCloud.open(argv[1])){
+            std::cerr << "Cannot open " << argv[1] << std::endl;
+            return 1;
+        }
+    }else if(!loadDcel(dcel, argv[1])){
+        return 1;
+    }
+
+    //Con meno di 4 punti (o con punti allineati o complanari) il convex hull è un punto, un segmento o un poligono
+    if((isPointCloud ? pointCloud.getSpan().numberPoints : dcel.getNumberVertices()) == 0){
+        std::cerr << argv[1] << " has no points" << std::endl;
+        return 1;
+    }
+
+    //La dcel contiene l'input (se non è un file binario) e conterrà il convex hull
+    ConvexHullCore convexHullCore(&dcel);
+    if(isPointCloud){
+        convexHullCore.setPoints(pointCloud.getSpan());
+    }
+    ConvexHullLog insertionLog;
+    if(!logFilename.empty()){
+        convexHullCore.setInsertionLog(&insertionLog);
+    }
+    if(!traceFilename.empty()){
+        ConvexHullTrace::start();
+    }
+    convexHullCore.findConvexHull();
+    ConvexHullTrace::stop();
+
+    if(!logFilename.empty() && !insertionLog.save(logFilename)){
+        std::cerr << "Cannot write " << logFilename << std::endl;
+        return 1;
+    }
+    if(!traceFilename.empty()){
+        if(!ConvexHullTrace::save(traceFilename)){
+            std::cerr << "Cannot write " << traceFilename << std::endl;
+            return 1;
+        }
+        //Senza CONVEXHULL_TRACE le macro CH_TRACE non registrano nulla
+        if(ConvexHullTrace::getNumberEvents() == 0){
+            std::cerr << "The trace is empty: build the library with CONVEXHULL_TRACE" << std::endl;
+        }
+        else if(ConvexHullTrace::getNumberDroppedEvents() > 0){
+            std::cerr << ConvexHullTrace::getNumberDroppedEvents() << " oldest events were overwritten" << std::endl;
+        }
+    }
+
+    if(!saveDcel(dcel, argv[2])){
+        return 1;
+    }
+    std::cout << "Vertices: " << dcel.getNumberVertices() << "; Half Edges: " << dcel.getNumberHalfEdges()
+              << "; Faces: " << dcel.getNumberFaces() << "." << std::endl;
+    #ifdef CONVEXHULL_STATS
+    convexHullCore.getStats().print(std::cout);
+    #endif
+    return 0;
+}
@@ -0,0 +1,732 @@
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Test automatici del convex hull, senza interfaccia grafica: ogni  *
+ * test controlla una parte dell'algoritmo (predicati, strategie,    *
+ * formati di ingresso e di uscita) e stampa i controlli falliti.    *
+ *                                                                   *
+ * Uso: ConvexHullTest (restituisce 0 se tutti i test passano)       *
+ *********************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "GUI/ConvexHullCore/convexhullbatch.h"
+#include "GUI/ConvexHullCore/convexhullcore.h"
+#include "GUI/ConvexHullCore/convexhulllog.h"
+#include "GUI/ConvexHullCore/convexhullplayer.h"
+#include "GUI/ConvexHullCore/convexhullstream.h"
+#include "GUI/ConvexHullCore/pointcloudfile.h"
+#include "GUI/ConvexHullCore/predicates.h"
+
+//Numero di controlli falliti: ogni CHECK fallito stampa la riga e il messaggio
+static int failures = 0;
+
+#define CHECK(condition, message) do { \
+    if(!(condition)){ \
+        failures++; \
+        std::cerr << __FILE__ << ":" << __LINE__ << ": " << message << std::endl; \
+    } \
+} while(0)
+
+/**
+ * @brief sign()
+ * This function return -1, 0 or 1 with the sign of the value
+ */
+static int sign(double value){
+    return value > 0 ? 1 : (value < 0 ? -1 : 0);
+}
+
+/**
+ * @brief testOrient3d()
+ * This function check that the filtered orient3d() has always the sign of orient3dExact(): on points of an integer
+ * lattice of a tilted plane (exactly coplanar, also far from the origin) the result must be exactly 0, and moving
+ * the fourth point by one ulp off the plane the sign must be the exact one, opposite for the two directions
+ */
+static void testOrient3d(){
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> lattice(-1000, 1000);
+    const double offsets[] = {0.0, 1e6, 1e12};
+
+    for(double offset : offsets){
+        //Il piano passa per origin ed è generato da u e v, a coordinate intere: tutti i punti sono rappresentabili esattamente
+        Pointd origin(offset + 3, offset - 7, offset + 11);
+        Pointd u(1, 2, 3), v(-2, 1, 5);
+        for(int test=0; test<2000; test++){
+            Pointd p[4];
+            for(int k=0; k<4; k++){
+                p[k] = origin + u * lattice(rng) + v * lattice(rng);
+            }
+            CHECK(Predicates::orient3d(p[0], p[1], p[2], p[3]) == 0.0, "orient3d of coplanar lattice points is not 0 (offset " << offset << ")");
+            CHECK(Predicates::orient3dExact(p[0], p[1], p[2], p[3]) == 0.0, "orient3dExact of coplanar lattice points is not 0");
+
+            //Se i primi tre punti sono allineati ogni quarto punto è complanare, lo spostamento non cambia nulla
+            if(Predicates::orient3dExact(p[0], p[1], p[2], p[3] + Pointd(0, 0, 1)) == 0.0){
+                continue;
+            }
+            Pointd above(p[3].x(), p[3].y(), std::nextafter(p[3].z(),  INFINITY));
+            Pointd below(p[3].x(), p[3].y(), std::nextafter(p[3].z(), -INFINITY));
+            int exactAbove = sign(Predicates::orient3dExact(p[0], p[1], p[2], above));
+            int exactBelow = sign(Predicates::orient3dExact(p[0], p[1], p[2], below));
+            CHECK(sign(Predicates::orient3d(p[0], p[1], p[2], above)) == exactAbove, "orient3d sign differs from the exact one one ulp above the plane");
+            CHECK(sign(Predicates::orient3d(p[0], p[1], p[2], below)) == exactBelow, "orient3d sign differs from the exact one one ulp below the plane");
+            CHECK(exactAbove != 0 && exactAbove == -exactBelow, "one ulp above and below the plane do not have opposite signs");
+        }
+    }
+
+    //Quasi allineati: punti su una diagonale vicino a 0.5, distanti pochi ulp (il caso in cui il determinante in double sbaglia)
+    Pointd a(12, 12, 12), b(24, 24, 24), c(24, 24, 12);
+    double step = std::nextafter(0.5, 1.0) - 0.5;
+    for(int i=0; i<64; i++){
+        for(int j=0; j<64; j++){
+            Pointd p(0.5 + i*step, 0.5 + j*step, 0.5);
+            CHECK(sign(Predicates::orient3d(a, b, c, p)) == sign(Predicates::orient3dExact(a, b, c, p)), "orient3d sign differs from the exact one near a degenerate configuration");
+        }
+    }
+}
+
+/**
+ * @brief findConvexHull()
+ * This function compute the convex hull of the points in the dcel
+ */
+static void findConvexHull(const std::vector<Pointd>& points, Dcel& dcel){
+    ConvexHullCore convexHullCore(points.data(), points.size(), &dcel);
+    convexHullCore.findConvexHull();
+}
+
+/**
+ * @brief getRandomPoints()
+ * This function return points with a normal distribution around the center: their convex hull has few vertices,
+ * so it can be checked against all the points
+ */
+static std::vector<Pointd> getRandomPoints(int numberPoints, unsigned int seed, const Pointd& center = Pointd(0, 0, 0)){
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<Pointd> points;
+    for(int i=0; i<numberPoints; i++){
+        points.push_back(center + Pointd(normal(rng), normal(rng), normal(rng)));
+    }
+    return points;
+}
+
+//Triangolo con i 3 vertici, ruotato in modo che il vertice minore sia il primo
+typedef std::array<Pointd, 3> Triangle;
+
+/**
+ * @brief getTriangle()
+ * This function return the triangle in the canonical form, with the same orientation
+ */
+static Triangle getTriangle(const Pointd& a, const Pointd& b, const Pointd& c){
+    if(b < a && b < c){
+        return Triangle{{b, c, a}};
+    }
+    if(c < a && c < b){
+        return Triangle{{c, a, b}};
+    }
+    return Triangle{{a, b, c}};
+}
+
+/**
+ * @brief getTriangles()
+ * This function return the faces of the dcel in a canonical form (rotated and sorted), so two dcel with the same
+ * faces have the same triangles, whatever the order of vertices and faces
+ */
+static std::vector<Triangle> getTriangles(const Dcel& dcel){
+    std::vector<Triangle> triangles;
+    for(Dcel::ConstFaceIterator fit = dcel.faceBegin(); fit != dcel.faceEnd(); ++fit){
+        const Dcel::HalfEdge* halfEdge = (*fit)->getOuterHalfEdge();
+        triangles.push_back(getTriangle(halfEdge->getFromVertex()->getCoordinate(),
+                                        halfEdge->getNext()->getFromVertex()->getCoordinate(),
+                                        halfEdge->getPrev()->getFromVertex()->getCoordinate()));
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+/**
+ * @brief isConvexHull()
+ * This function return true if the triangles are the convex hull of the points: their vertices are input points,
+ * every edge has its twin (a closed surface with V - E + F = 2) and no point is outside of a triangle
+ */
+static bool isConvexHull(const std::vector<Triangle>& triangles, std::vector<Pointd> points){
+    if(triangles.empty()){
+        return false;
+    }
+    std::sort(points.begin(), points.end());
+    std::vector<Pointd> vertices;
+    std::vector<std::pair<Pointd, Pointd> > edges, twins;
+    for(const Triangle& triangle : triangles){
+        for(int k=0; k<3; k++){
+            if(!std::binary_search(points.begin(), points.end(), triangle[k])){
+                return false;
+            }
+            vertices.push_back(triangle[k]);
+            edges.push_back(std::make_pair(triangle[k], triangle[(k+1)%3]));
+            twins.push_back(std::make_pair(triangle[(k+1)%3], triangle[k]));
+        }
+    }
+    std::sort(vertices.begin(), vertices.end());
+    std::sort(edges.begin(), edges.end());
+    std::sort(twins.begin(), twins.end());
+    int numberVertices = std::unique(vertices.begin(), vertices.end()) - vertices.begin();
+    if(edges != twins || std::adjacent_find(edges.begin(), edges.end()) != edges.end() ||
+       numberVertices - (int)edges.size() / 2 + (int)triangles.size() != 2){
+        return false;
+    }
+    for(const Triangle& triangle : triangles){
+        for(const Pointd& point : points){
+            if(Predicates::orient3d(triangle[0], triangle[1], triangle[2], point) > 0){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief testNumberThreads()
+ * This function check that the convex hull does not depend on the number of threads that initialize and update
+ * the conflict graph
+ */
+static void testNumberThreads(){
+    std::vector<Pointd> points = getRandomPoints(20000, 1);
+    std::vector<Triangle> expected;
+    const int numberThreads[] = {1, 2, 4};
+    for(int threads : numberThreads){
+        Dcel dcel;
+        ConvexHullCore convexHullCore(points.data(), points.size(), &dcel);
+        convexHullCore.setNumberThreads(threads);
+        convexHullCore.findConvexHull();
+        std::vector<Triangle> triangles = getTriangles(dcel);
+        if(threads == 1){
+            CHECK(isConvexHull(triangles, points), "1 thread: the result is not the convex hull of the points");
+            expected = triangles;
+        }else{
+            CHECK(triangles == expected, threads << " threads: the convex hull differs from the one of 1 thread");
+        }
+    }
+}
+
+/**
+ * @brief testDivideAndConquer()
+ * This function check that PARALLEL_DIVIDE_AND_CONQUER gives the convex hull of the points, the same of the serial
+ * algorithm. On points in general position the triangles are the same, on a lattice (coplanar points on the faces
+ * and collinear points on the edges) only the geometric convex hull is, not its vertices
+ */
+static void testDivideAndConquer(){
+    std::vector<Pointd> cloud = getRandomPoints(20000, 2, Pointd(1e6, -1e6, 1e6));
+    std::vector<Pointd> lattice;
+    for(int x=0; x<21; x++){
+        for(int y=0; y<21; y++){
+            for(int z=0; z<21; z++){
+                lattice.push_back(Pointd(x, y, z));
+            }
+        }
+    }
+
+    const std::vector<Pointd>* inputs[] = {&cloud, &lattice};
+    for(const std::vector<Pointd>* points : inputs){
+        const char* name = points == &cloud ? "cloud" : "lattice";
+        Dcel serialDcel, parallelDcel;
+        findConvexHull(*points, serialDcel);
+        ConvexHullCore convexHullCore(points->data(), points->size(), &parallelDcel);
+        convexHullCore.setStrategy(ConvexHullCore::PARALLEL_DIVIDE_AND_CONQUER);
+        convexHullCore.setNumberThreads(2);
+        convexHullCore.findConvexHull();
+        std::vector<Triangle> serial = getTriangles(serialDcel), parallel = getTriangles(parallelDcel);
+        CHECK(isConvexHull(serial, *points), name << ": the serial result is not the convex hull of the points");
+        CHECK(isConvexHull(parallel, *points), name << ": the divide and conquer result is not the convex hull of the points");
+        if(points == &cloud){
+            CHECK(parallel == serial, name << ": the divide and conquer convex hull differs from the serial one");
+        }
+    }
+}
+
+/**
+ * @brief testInteriorCulling()
+ * This function check that the culling of the interior points does not change the convex hull, with both the
+ * serial and the divide and conquer strategy
+ */
+static void testInteriorCulling(){
+    std::vector<Pointd> points = getRandomPoints(20000, 3);
+    Dcel expectedDcel;
+    findConvexHull(points, expectedDcel);
+    std::vector<Triangle> expected = getTriangles(expectedDcel);
+
+    const ConvexHullCore::Strategy strategies[] = {ConvexHullCore::INCREMENTAL, ConvexHullCore::PARALLEL_DIVIDE_AND_CONQUER};
+    for(ConvexHullCore::Strategy strategy : strategies){
+        Dcel dcel;
+        ConvexHullCore convexHullCore(points.data(), points.size(), &dcel);
+        convexHullCore.setStrategy(strategy);
+        convexHullCore.setNumberThreads(2);
+        convexHullCore.setInteriorCulling(true);
+        convexHullCore.findConvexHull();
+        CHECK(getTriangles(dcel) == expected, "strategy " << strategy << ": the convex hull with culling differs from the one without");
+    }
+}
+
+/**
+ * @brief hasValidHalfEdges()
+ * This function return true if every half edge of the dcel has a twin that points back to it and goes in the
+ * opposite direction
+ */
+static bool hasValidHalfEdges(const Dcel& dcel){
+    for(Dcel::ConstHalfEdgeIterator heit = dcel.halfEdgeBegin(); heit != dcel.halfEdgeEnd(); ++heit){
+        const Dcel::HalfEdge* halfEdge = *heit;
+        const Dcel::HalfEdge* twin = halfEdge->getTwin();
+        if(twin == nullptr || twin->getTwin() != halfEdge || twin->getFromVertex() != halfEdge->getToVertex()){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief hasVertices()
+ * This function return true if the vertices of the dcel are exactly the expected points (in any order)
+ */
+static bool hasVertices(const Dcel& dcel, std::vector<Pointd> expected){
+    std::vector<Pointd> vertices;
+    for(Dcel::ConstVertexIterator vit = dcel.vertexBegin(); vit != dcel.vertexEnd(); ++vit){
+        vertices.push_back((*vit)->getCoordinate());
+    }
+    std::sort(vertices.begin(), vertices.end());
+    std::sort(expected.begin(), expected.end());
+    return vertices == expected;
+}
+
+/**
+ * @brief testDegenerateHulls()
+ * This function check the convex hull of points that are not full dimensional: coincident points give one vertex,
+ * collinear points the segment between the two extremes (two twin half edges, no faces) and coplanar points the
+ * flat polygon of their convex hull in the plane, without the collinear points on its boundary
+ */
+static void testDegenerateHulls(){
+
+    //Punti coincidenti
+    {
+        std::vector<Pointd> points(100, Pointd(1, 2, 3));
+        Dcel dcel;
+        findConvexHull(points, dcel);
+        CHECK(dcel.getNumberVertices() == 1 && dcel.getNumberFaces() == 0, "coincident points: expected 1 vertex, got " << dcel.getNumberVertices());
+        CHECK(hasVertices(dcel, {Pointd(1, 2, 3)}), "coincident points: wrong vertex");
+    }
+
+    //Punti allineati, gli estremi non sono i primi punti
+    {
+        std::vector<Pointd> points;
+        for(int i=0; i<=100; i++){
+            int t = (i * 37) % 101 - 50;
+            points.push_back(Pointd(1 + 3*t, 2 - 2*t, 3 + 5*t));
+        }
+        Dcel dcel;
+        findConvexHull(points, dcel);
+        CHECK(dcel.getNumberVertices() == 2 && dcel.getNumberHalfEdges() == 2 && dcel.getNumberFaces() == 0, "collinear points: expected a segment, got " << dcel.getNumberVertices() << " vertices and " << dcel.getNumberFaces() << " faces");
+        CHECK(hasVertices(dcel, {Pointd(1 - 150, 2 + 100, 3 - 250), Pointd(1 + 150, 2 - 100, 3 + 250)}), "collinear points: the vertices are not the extremes");
+        CHECK(hasValidHalfEdges(dcel), "collinear points: the half edges are not twins");
+    }
+
+    //Punti coplanari di un reticolo su un piano inclinato: il convex hull è il parallelogramma dei 4 angoli, i punti
+    //sui lati sono allineati e vengono scartati
+    {
+        Pointd origin(5, -3, 7), u(1, 2, 3), v(-2, 1, 5);
+        std::vector<Pointd> points;
+        for(int a=0; a<=20; a++){
+            for(int b=0; b<=20; b++){
+                points.push_back(origin + u * ((a * 8) % 21) + v * ((b * 13) % 21));
+            }
+        }
+        Dcel dcel;
+        findConvexHull(points, dcel);
+        CHECK(dcel.getNumberVertices() == 4, "coplanar points: expected 4 vertices, got " << dcel.getNumberVertices());
+        CHECK(dcel.getNumberFaces() == 2 * (4 - 2), "coplanar points: expected a fan of 2 triangles for each side, got " << dcel.getNumberFaces() << " faces");
+        CHECK(hasVertices(dcel, {origin, origin + u * 20, origin + v * 20, origin + u * 20 + v * 20}), "coplanar points: the vertices are not the corners");
+        CHECK(hasValidHalfEdges(dcel), "coplanar points: the half edges are not twins");
+    }
+}
+
+/**
+ * @brief testQuickhull()
+ * This function check that the QUICKHULL strategy gives the same convex hull of the incremental algorithm on points
+ * in general position, and a convex hull of coplanar points of a lattice
+ */
+static void testQuickhull(){
+    std::vector<Pointd> points = getRandomPoints(20000, 4);
+    Dcel expectedDcel, dcel;
+    findConvexHull(points, expectedDcel);
+    ConvexHullCore convexHullCore(points.data(), points.size(), &dcel);
+    convexHullCore.setStrategy(ConvexHullCore::QUICKHULL);
+    convexHullCore.findConvexHull();
+    CHECK(getTriangles(dcel) == getTriangles(expectedDcel), "the quickhull convex hull differs from the incremental one");
+
+    std::vector<Pointd> lattice;
+    for(int x=0; x<11; x++){
+        for(int y=0; y<11; y++){
+            for(int z=0; z<11; z++){
+                lattice.push_back(Pointd(x, y, z));
+            }
+        }
+    }
+    Dcel latticeDcel;
+    ConvexHullCore latticeCore(lattice.data(), lattice.size(), &latticeDcel);
+    latticeCore.setStrategy(ConvexHullCore::QUICKHULL);
+    latticeCore.findConvexHull();
+    CHECK(isConvexHull(getTriangles(latticeDcel), lattice), "lattice: the quickhull result is not the convex hull of the points");
+}
+
+/**
+ * @brief getSpherePoints()
+ * This function return points near the sphere with the given center and radius (moved randomly by up to 1e-3 in
+ * every coordinate): many of them are on the convex hull or very close to its faces
+ */
+static std::vector<Pointd> getSpherePoints(int numberPoints, unsigned int seed, const Pointd& center, double radius){
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal(0, 1);
+    std::uniform_real_distribution<double> noise(-1e-3, 1e-3);
+    std::vector<Pointd> points;
+    for(int i=0; i<numberPoints; i++){
+        Pointd direction(normal(rng), normal(rng), normal(rng));
+        points.push_back(center + direction * (radius / direction.getLength()) + Pointd(noise(rng), noise(rng), noise(rng)));
+    }
+    return points;
+}
+
+/**
+ * @brief testInsertPoints()
+ * This function check that inserting the points in groups with insertPoints() gives the convex hull of
+ * findConvexHull(), also on a small sphere far from the origin, where the rounding errors of the planes are bigger
+ * than the distances between the points and the faces
+ */
+static void testInsertPoints(){
+    const Pointd centers[] = {Pointd(0, 0, 0), Pointd(1e9, 1e9, 1e9)};
+    for(const Pointd& center : centers){
+        std::vector<Pointd> points = getSpherePoints(20000, 5, center, 0.01);
+        Dcel dcel, expectedDcel;
+        ConvexHullCore convexHullCore(&dcel);
+        for(size_t i=0; i<points.size(); i+=997){
+            convexHullCore.insertPoints(points.data() + i, std::min<size_t>(997, points.size() - i));
+        }
+        findConvexHull(points, expectedDcel);
+        std::vector<Triangle> triangles = getTriangles(dcel);
+        CHECK(isConvexHull(triangles, points), "center " << center.x() << ": the online result is not the convex hull of the points");
+        CHECK(triangles == getTriangles(expectedDcel), "center " << center.x() << ": the online convex hull differs from findConvexHull()");
+    }
+}
+
+/**
+ * @brief testBatch()
+ * This function check that every convex hull computed by ConvexHullBatch is the one of findConvexHull() on its
+ * set of points, also for the degenerate sets (coplanar points give a polygon with two faces)
+ */
+static void testBatch(){
+    std::vector<Pointd> points;
+    std::vector<int> offsets(1, 0);
+    const int numberSets = 200;
+    for(int set=0; set<numberSets; set++){
+        std::vector<Pointd> setPoints = getRandomPoints(4 + (set * 37) % 197, 100 + set);
+        for(Pointd& p : setPoints){
+            if(set % 10 == 0){
+                p.setZ(0);
+            }
+            points.push_back(p);
+        }
+        offsets.push_back(points.size());
+    }
+
+    ConvexHullBatch batch(4);
+    ConvexHullBatch::Output output;
+    batch.compute(points.data(), offsets.data(), numberSets, output);
+    CHECK((int)output.vertices.size() == 3 * output.vertexOffsets[numberSets] && (int)output.triangles.size() == 3 * output.triangleOffsets[numberSets], "the output has the wrong size");
+
+    for(int set=0; set<numberSets; set++){
+        std::vector<Triangle> triangles;
+        for(int t=output.triangleOffsets[set]; t<output.triangleOffsets[set+1]; t++){
+            Pointd p[3];
+            for(int k=0; k<3; k++){
+                const double* vertex = &output.vertices[3 * (output.vertexOffsets[set] + output.triangles[3*t+k])];
+                p[k] = Pointd(vertex[0], vertex[1], vertex[2]);
+            }
+            triangles.push_back(getTriangle(p[0], p[1], p[2]));
+        }
+        std::sort(triangles.begin(), triangles.end());
+        Dcel dcel;
+        findConvexHull(std::vector<Pointd>(points.begin() + offsets[set], points.begin() + offsets[set+1]), dcel);
+        CHECK(triangles == getTriangles(dcel), "set " << set << ": the batch convex hull differs from findConvexHull()");
+        CHECK(output.vertexOffsets[set+1] - output.vertexOffsets[set] == dcel.getNumberVertices(), "set " << set << ": wrong number of vertices");
+    }
+}
+
+/**
+ * @brief testStream()
+ * This function check that ConvexHullStream, with blocks smaller than the points, gives the convex hull of
+ * findConvexHull(), also on a small sphere far from the origin. The first points are coplanar, so the online
+ * convex hull stays flat (and its points are kept aside) for the first blocks
+ */
+static void testStream(){
+    const Pointd center(1e9, 1e9, 1e9);
+    std::vector<Pointd> points = getSpherePoints(50000, 6, center, 0.01);
+    for(int i=0; i<1000; i++){
+        points[i].setZ(center.z());
+    }
+
+    Dcel dcel, expectedDcel;
+    ConvexHullStream stream(&dcel, 4096);
+    for(size_t i=0; i<points.size(); i+=1000){
+        stream.addPoints(points.data() + i, std::min<size_t>(1000, points.size() - i));
+    }
+    stream.flush();
+    findConvexHull(points, expectedDcel);
+    std::vector<Triangle> triangles = getTriangles(dcel);
+    CHECK(stream.getNumberPoints() == points.size(), "the stream counted " << stream.getNumberPoints() << " points");
+    CHECK(isConvexHull(triangles, points), "the stream result is not the convex hull of the points");
+    CHECK(triangles == getTriangles(expectedDcel), "the stream convex hull differs from findConvexHull()");
+}
+
+/**
+ * @brief testPointCloudFile()
+ * This function save points in a .xyzb file, in double and in float, and check that the mapped file has the same
+ * coordinates. A file with a wrong header must not be opened
+ */
+static void testPointCloudFile(){
+    std::vector<Pointd> points = getRandomPoints(1000, 7, Pointd(1e3, 0, -1e3));
+    std::vector<double> coordinates;
+    std::vector<float> floatCoordinates;
+    for(const Pointd& p : points){
+        const double xyz[] = {p.x(), p.y(), p.z()};
+        coordinates.insert(coordinates.end(), xyz, xyz + 3);
+        floatCoordinates.insert(floatCoordinates.end(), xyz, xyz + 3);
+    }
+    const std::string filename = "convexhull_test.xyzb";
+
+    for(int singlePrecision=0; singlePrecision<2; singlePrecision++){
+        PointSpan saved = singlePrecision ? PointSpan(floatCoordinates.data(), points.size(), true) : PointSpan(coordinates.data(), points.size());
+        CHECK(PointCloudFile::save(filename, saved), "cannot save the points");
+        PointCloudFile file;
+        CHECK(file.open(filename), "cannot open the saved points");
+        PointSpan span = file.getSpan();
+        CHECK(span.size() == saved.size(), "the file has " << span.size() << " points");
+        bool same = span.size() == saved.size();
+        for(int i=0; same && i<span.size(); i++){
+            same = span.getPoint(i) == saved.getPoint(i);
+        }
+        CHECK(same, "the points read differ from the saved ones (single precision " << singlePrecision << ")");
+    }
+
+    //Intestazione non valida
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    std::fwrite("NOTPOINT", 1, 8, file);
+    std::fwrite(coordinates.data(), sizeof(double), coordinates.size(), file);
+    std::fclose(file);
+    PointCloudFile invalid;
+    CHECK(!invalid.open(filename), "a file without the magic has been opened");
+    std::remove(filename.c_str());
+}
+
+/**
+ * @brief getTriangles()
+ * This function return the triangles of the mesh in the canonical form of the faces of a dcel
+ */
+static std::vector<Triangle> getTriangles(const ConvexHullCore::Mesh& mesh){
+    std::vector<Triangle> triangles;
+    for(int t=0; t<mesh.getNumberTriangles(); t++){
+        Pointd p[3];
+        for(int k=0; k<3; k++){
+            const double* vertex = &mesh.vertices[3 * mesh.triangles[3*t+k]];
+            p[k] = Pointd(vertex[0], vertex[1], vertex[2]);
+        }
+        triangles.push_back(getTriangle(p[0], p[1], p[2]));
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+/**
+ * @brief testMesh()
+ * This function check the mesh of findConvexHull(Mesh&): the triangles are the faces of the dcel, every triangle
+ * is adjacent to the one with the twin edge and no point is outside of the plane of a triangle
+ */
+static void testMesh(){
+    std::vector<Pointd> points = getRandomPoints(5000, 8, Pointd(10, 20, 30));
+    Dcel dcel;
+    ConvexHullCore convexHullCore(points.data(), points.size(), &dcel);
+    ConvexHullCore::Mesh mesh;
+    convexHullCore.findConvexHull(mesh, ConvexHullCore::MESH_PLANES | ConvexHullCore::MESH_ADJACENCY);
+    int numberTriangles = mesh.getNumberTriangles();
+    CHECK(getTriangles(mesh) == getTriangles(dcel), "the triangles of the mesh are not the faces of the dcel");
+    CHECK((int)mesh.planes.size() == 4 * numberTriangles && (int)mesh.adjacency.size() == 3 * numberTriangles, "the mesh has no planes or adjacency");
+
+    for(int t=0; t<numberTriangles && (int)mesh.adjacency.size() == 3 * numberTriangles; t++){
+        for(int k=0; k<3; k++){
+            int from = mesh.triangles[3*t+k], to = mesh.triangles[3*t+(k+1)%3];
+            int neighbour = mesh.adjacency[3*t+k];
+            bool twin = false;
+            for(int j=0; neighbour >= 0 && j<3; j++){
+                twin = twin || (mesh.triangles[3*neighbour+j] == to && mesh.triangles[3*neighbour+(j+1)%3] == from);
+            }
+            CHECK(twin, "triangle " << t << ": the adjacent triangle of the edge " << k << " has not its twin");
+        }
+    }
+
+    for(int t=0; t<numberTriangles && (int)mesh.planes.size() == 4 * numberTriangles; t++){
+        const double* plane = &mesh.planes[4*t];
+        CHECK(std::fabs(plane[0]*plane[0] + plane[1]*plane[1] + plane[2]*plane[2] - 1) < 1e-12, "triangle " << t << ": the normal is not unit");
+        double maxValue = -INFINITY, maxVertexValue = 0;
+        for(const Pointd& p : points){
+            maxValue = std::max(maxValue, plane[0]*p.x() + plane[1]*p.y() + plane[2]*p.z() + plane[3]);
+        }
+        for(int k=0; k<3; k++){
+            const double* v = &mesh.vertices[3 * mesh.triangles[3*t+k]];
+            maxVertexValue = std::max(maxVertexValue, std::fabs(plane[0]*v[0] + plane[1]*v[1] + plane[2]*v[2] + plane[3]));
+        }
+        CHECK(maxValue < 1e-9 && maxVertexValue < 1e-9, "triangle " << t << ": the points are not below its plane");
+    }
+}
+
+/**
+ * @brief testPointSpan()
+ * This function check that the convex hull of a span of coordinates, in double and in float, is the one of the
+ * same points in an array of Pointd
+ */
+static void testPointSpan(){
+    std::vector<Pointd> points = getRandomPoints(5000, 9);
+    std::vector<double> coordinates;
+    std::vector<float> floatCoordinates;
+    for(const Pointd& p : points){
+        const double xyz[] = {p.x(), p.y(), p.z()};
+        coordinates.insert(coordinates.end(), xyz, xyz + 3);
+        floatCoordinates.insert(floatCoordinates.end(), xyz, xyz + 3);
+    }
+    //Gli stessi punti arrotondati a float
+    PointSpan floatSpan(floatCoordinates.data(), points.size(), true);
+    std::vector<Pointd> floatPoints;
+    for(int i=0; i<floatSpan.size(); i++){
+        floatPoints.push_back(floatSpan.getPoint(i));
+    }
+
+    Dcel expectedDcel, dcel, floatExpectedDcel, floatDcel;
+    findConvexHull(points, expectedDcel);
+    findConvexHull(floatPoints, floatExpectedDcel);
+    ConvexHullCore convexHullCore(PointSpan(coordinates.data(), points.size()), &dcel);
+    convexHullCore.findConvexHull();
+    ConvexHullCore floatCore(floatSpan, &floatDcel);
+    floatCore.findConvexHull();
+    CHECK(getTriangles(dcel) == getTriangles(expectedDcel), "the convex hull of the span differs from the one of the array");
+    CHECK(getTriangles(floatDcel) == getTriangles(floatExpectedDcel), "the convex hull of the float span differs from the one of the array");
+}
+
+/**
+ * @brief testLogReplay()
+ * This function record the construction of the convex hull, save and load the log and check that the player
+ * reaches the same convex hull of findConvexHull() after the last step, also moving back and forth
+ */
+static void testLogReplay(ConvexHullCore::Strategy strategy, const char* name){
+
+    std::mt19937 rng(7);
+    std::normal_distribution<double> normal(0, 1);
+    std::vector<Pointd> points;
+    for(int i=0; i<3000; i++){
+        Pointd p(normal(rng), normal(rng), normal(rng));
+        //Metà dei punti sulla sfera, metà all'interno
+        points.push_back(i % 2 ? p / p.getLength() : p * 0.3);
+    }
+
+    Dcel dcel;
+    ConvexHullCore convexHullCore(points.data(), points.size(), &dcel);
+    convexHullCore.setStrategy(strategy);
+    ConvexHullLog log;
+    convexHullCore.setInsertionLog(&log);
+    convexHullCore.findConvexHull();
+    ConvexHullCore::Mesh expected;
+    convexHullCore.getMesh(expected);
+
+    const std::string filename = std::string("convexhull_test.") + ConvexHullLog::EXTENSION;
+    CHECK(log.save(filename), name << ": cannot save the log");
+    ConvexHullLog loaded;
+    CHECK(loaded.load(filename), name << ": cannot load the log");
+    std::remove(filename.c_str());
+    CHECK(loaded.getNumberSteps() == log.getNumberSteps() && loaded.getNumberFaces() == log.getNumberFaces(), name << ": the loaded log is different");
+
+    ConvexHullPlayer player(loaded);
+    ConvexHullCore::Mesh mesh;
+    int lastStep = player.getNumberSteps();
+    const int steps[] = {lastStep, 0, lastStep / 2, lastStep, lastStep / 3, lastStep};
+    for(int step : steps){
+        player.seek(step);
+        CHECK(player.getStep() == step, name << ": seek(" << step << ") stopped at " << player.getStep());
+        player.getMesh(mesh);
+        if(step == 0){
+            CHECK(mesh.getNumberTriangles() == 4, name << ": the initial convex hull is not a tetrahedron");
+        }
+        if(step == lastStep){
+            CHECK(getTriangles(mesh) == getTriangles(expected), name << ": the replayed convex hull differs from findConvexHull()");
+        }
+        //Ogni convex hull intermedio è una superficie chiusa di triangoli: V - E + F = 2 con E = 3F/2
+        CHECK(2 * mesh.getNumberVertices() - mesh.getNumberTriangles() == 4, name << ": the convex hull after step " << step << " is not closed");
+    }
+}
+
+/**
+ * @brief testInsertionOrder()
+ * This function check that BRIO_ORDER gives the convex hull of RANDOM_ORDER and that, with the same seed, the
+ * insertions are the same: the number of faces after every step does not change from an execution to the next
+ */
+static void testInsertionOrder(){
+    std::vector<Pointd> points = getRandomPoints(20000, 10);
+    Dcel expectedDcel;
+    findConvexHull(points, expectedDcel);
+    std::vector<Triangle> expected = getTriangles(expectedDcel);
+
+    const ConvexHullCore::Strategy strategies[] = {ConvexHullCore::INCREMENTAL, ConvexHullCore::PARALLEL_DIVIDE_AND_CONQUER};
+    for(ConvexHullCore::Strategy strategy : strategies){
+        std::vector<int> faces[3];
+        const unsigned int seeds[] = {1, 1, 2};
+        for(int run=0; run<3; run++){
+            Dcel dcel;
+            ConvexHullCore convexHullCore(points.data(), points.size(), &dcel);
+            convexHullCore.setStrategy(strategy);
+            convexHullCore.setNumberThreads(2);
+            convexHullCore.setInsertionOrder(ConvexHullCore::BRIO_ORDER);
+            convexHullCore.setRandomSeed(seeds[run]);
+            convexHullCore.setStepCallback([&](){
+                faces[run].push_back(dcel.getNumberFaces());
+            });
+            convexHullCore.findConvexHull();
+            CHECK(getTriangles(dcel) == expected, "strategy " << strategy << ", seed " << seeds[run] << ": the BRIO convex hull differs from the random one");
+        }
+        CHECK(!faces[0].empty() && faces[0] == faces[1], "strategy " << strategy << ": two executions with the same seed differ");
+        CHECK(faces[0] != faces[2], "strategy " << strategy << ": two executions with different seeds are the same");
+    }
+}
+
+int main() {
+
+    testOrient3d();
+    testNumberThreads();
+    testDivideAndConquer();
+    testInteriorCulling();
+    testDegenerateHulls();
+    testQuickhull();
+    testInsertPoints();
+    testBatch();
+    testStream();
+    testPointCloudFile();
+    testMesh();
+    testPointSpan();
+    testLogReplay(ConvexHullCore::INCREMENTAL, "incremental");
+    testLogReplay(ConvexHullCore::QUICKHULL, "quickhull");
+    testInsertionOrder();
+
+    if(failures > 0){
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "convexhullbatch.h"
+#include <algorithm>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief ConvexHullBatch::ConvexHullBatch()
+ * This method is the constructor of the ConvexHullBatch class. numberThreads is the number of threads used by
+ * compute(), the calling thread included (0 means one for every core). The QUICKHULL strategy is the default,
+ * the fastest on small sets
+ */
+ConvexHullBatch::ConvexHullBatch(int numberThreads) : threadPool(numberThreads){
+    this -> strategy = ConvexHullCore::QUICKHULL;
+}
+
+/**
+ * @brief ConvexHullBatch::setStrategy()
+ * This method select the algorithm used for every set (see ConvexHullCore::setStrategy())
+ */
+void ConvexHullBatch::setStrategy(ConvexHullCore::Strategy strategy){
+    this -> strategy = strategy;
+}
+
+/**
+ * @brief ConvexHullBatch::takeScratch()
+ * This method return a free working memory, creating it if all the existing ones are in use (there are at most
+ * as many as the threads of the pool)
+ */
+ConvexHullBatch::Scratch* ConvexHullBatch::takeScratch(){
+
+    std::lock_guard<std::mutex> lock(scratchMutex);
+    if(freeScratches.empty()){
+        scratches.push_back(std::unique_ptr<Scratch>(new Scratch()));
+        return scratches.back().get();
+    }
+    Scratch* scratch = freeScratches.back();
+    freeScratches.pop_back();
+    return scratch;
+}
+
+/**
+ * @brief ConvexHullBatch::releaseScratch()
+ * This method give back a working memory taken with takeScratch()
+ */
+void ConvexHullBatch::releaseScratch(Scratch* scratch){
+    std::lock_guard<std::mutex> lock(scratchMutex);
+    freeScratches.push_back(scratch);
+}
+
+/**
+ * @brief ConvexHullBatch::appendHull()
+ * This method append the convex hull in the dcel of the working memory to the results of the block
+ */
+void ConvexHullBatch::appendHull(Scratch& scratch, BlockOutput& block, int& numberVertices, int& numberTriangles){
+
+    //Indice di ogni vertice (per id nella dcel) relativo al primo vertice dell'insieme
+    numberVertices = 0;
+    for(Dcel::VertexIterator vit = scratch.dcel.vertexBegin(); vit != scratch.dcel.vertexEnd(); ++vit){
+        unsigned int vertexId = (*vit)->getId();
+        if(vertexId >= scratch.localIndex.size()){
+            scratch.localIndex.resize(vertexId+1);
+        }
+        scratch.localIndex[vertexId] = numberVertices++;
+        Pointd p = (*vit)->getCoordinate();
+        block.vertices.push_back(p.x());
+        block.vertices.push_back(p.y());
+        block.vertices.push_back(p.z());
+    }
+
+    numberTriangles = 0;
+    for(Dcel::FaceIterator fit = scratch.dcel.faceBegin(); fit != scratch.dcel.faceEnd(); ++fit){
+        Dcel::HalfEdge* halfEdge = (*fit)->getOuterHalfEdge();
+        for(int k=0; k<3; k++, halfEdge = halfEdge->getNext()){
+            block.triangles.push_back(scratch.localIndex[halfEdge->getFromVertex()->getId()]);
+        }
+        numberTriangles++;
+    }
+}
+
+/**
+ * @brief ConvexHullBatch::compute()
+ * This method compute the convex hull of numberSets sets of points: the set i is points[offsets[i]] ...
+ * points[offsets[i+1]-1]. The sets are split in blocks of BATCH_GRAIN that are elaborated in parallel, then
+ * the results of the blocks are copied (in parallel) in their positions of the output
+ */
+void ConvexHullBatch::compute(const Pointd* points, const int* offsets, int numberSets, Output& output){
+
+    int numberBlocks = (numberSets + BATCH_GRAIN - 1) / BATCH_GRAIN;
+    std::vector<int> vertexCount(numberSets), triangleCount(numberSets);
+    if((int) blocks.size() < numberBlocks){
+        blocks.resize(numberBlocks);
+    }
+
+    //Convex hull dei blocchi: ogni chiamata del corpo usa la stessa memoria di lavoro per tutti i suoi blocchi
+    threadPool.parallelFor(0, numberBlocks, 1, [&](int firstBlock, int lastBlock){
+        Scratch* scratch = takeScratch();
+        scratch->core.setStrategy(strategy);
+        for(int b=firstBlock; b<lastBlock; b++){
+            CH_TRACE("batchBlock");
+            BlockOutput& block = blocks[b];
+            block.vertices.clear();
+            block.triangles.clear();
+            int lastSet = std::min((b+1) * BATCH_GRAIN, numberSets);
+            for(int set=b*BATCH_GRAIN; set<lastSet; set++){
+                scratch->core.setPoints(points + offsets[set], offsets[set+1] - offsets[set]);
+                scratch->core.findConvexHull();
+                appendHull(*scratch, block, vertexCount[set], triangleCount[set]);
+            }
+        }
+        releaseScratch(scratch);
+    });
+
+    //Posizioni nell'output
+    output.vertexOffsets.resize(numberSets+1);
+    output.triangleOffsets.resize(numberSets+1);
+    output.vertexOffsets[0]   = 0;
+    output.triangleOffsets[0] = 0;
+    for(int set=0; set<numberSets; set++){
+        output.vertexOffsets[set+1]   = output.vertexOffsets[set]   + vertexCount[set];
+        output.triangleOffsets[set+1] = output.triangleOffsets[set] + triangleCount[set];
+    }
+    output.vertices.resize(3 * output.vertexOffsets[numberSets]);
+    output.triangles.resize(3 * output.triangleOffsets[numberSets]);
+
+    threadPool.parallelFor(0, numberBlocks, 1, [&](int firstBlock, int lastBlock){
+        for(int b=firstBlock; b<lastBlock; b++){
+            std::copy(blocks[b].vertices.begin(), blocks[b].vertices.end(), output.vertices.begin() + 3 * output.vertexOffsets[b*BATCH_GRAIN]);
+            std::copy(blocks[b].triangles.begin(), blocks[b].triangles.end(), output.triangles.begin() + 3 * output.triangleOffsets[b*BATCH_GRAIN]);
+        }
+    });
+}
@@ -0,0 +1,71 @@
+#ifndef CONVEXHULLBATCH_H
+#define CONVEXHULLBATCH_H
+
+#include "lib/dcel/dcel.h"
+#include "convexhullcore.h"
+#include "threadpool.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Convex hull di molti insiemi di punti piccoli. Gli insiemi sono   *
+ * divisi in blocchi elaborati in parallelo dal thread pool; ogni    *
+ * thread usa una memoria di lavoro (dcel, ConvexHullCore e buffer)  *
+ * che viene riusata per tutti i suoi insiemi, quindi i contenitori  *
+ * non vengono riallocati per ogni convex hull. I risultati finiscono*
+ * in un unico buffer compatto di vertici e triangoli.               *
+ *********************************************************************/
+
+class ConvexHullBatch{
+
+public:
+    //Convex hull di tutti gli insiemi: vertices contiene le coordinate x y z di ogni vertice, i vertici dell'insieme i
+    //sono in [vertexOffsets[i], vertexOffsets[i+1]) e i suoi triangoli in [triangleOffsets[i], triangleOffsets[i+1]).
+    //Ogni triangolo sono 3 indici relativi al primo vertice dell'insieme, in senso antiorario visto da fuori (un
+    //insieme degenere ha un poligono a due facce o nessun triangolo)
+    struct Output{
+        std::vector<double> vertices;
+        std::vector<int>    triangles;
+        std::vector<int>    vertexOffsets;
+        std::vector<int>    triangleOffsets;
+    };
+
+    //Numero di insiemi elaborati da un thread per ogni blocco
+    static const int BATCH_GRAIN = 16;
+
+    explicit ConvexHullBatch(int numberThreads = 0);
+    void setStrategy(ConvexHullCore::Strategy strategy);
+    void compute(const Pointd* points, const int* offsets, int numberSets, Output& output);
+
+private:
+    //Memoria di lavoro di un thread
+    struct Scratch{
+        Dcel             dcel;
+        ConvexHullCore   core;
+        std::vector<int> localIndex;
+        Scratch() : core(&dcel){}
+    };
+
+    //Risultati di un blocco di insiemi, copiati nell'output una volta note le posizioni
+    struct BlockOutput{
+        std::vector<double> vertices;
+        std::vector<int>    triangles;
+    };
+
+    Scratch* takeScratch();
+    void releaseScratch(Scratch* scratch);
+    static void appendHull(Scratch& scratch, BlockOutput& block, int& numberVertices, int& numberTriangles);
+
+    ThreadPool threadPool;
+    ConvexHullCore::Strategy strategy;
+    std::vector<std::unique_ptr<Scratch> > scratches;
+    std::vector<Scratch*> freeScratches;
+    std::mutex scratchMutex;
+    std::vector<BlockOutput> blocks;
+};
+
+#endif // CONVEXHULLBATCH_H
@@ -18,15 +18,49 @@
 /**
 * @brief ConvexHullCore::ConvexHullCore()
 * This method is the constructor the class. Receive as input the pointer
-* of the dcel, the pointer of the mainWindow and the const variable isClicked (if the user would see the interactive convex hull)
+* of the dcel, whose vertices are the input points and that will contain the convex hull,
+* and the (optional) callback called after every inserted point (if the user would see the interactive convex hull).
+* Without an array of points the input points are the vertices of the dcel
 */
-ConvexHullCore::ConvexHullCore(DrawableDcel *dcel,MainWindow* mainWindow,const bool isClicked):isClicked(isClicked){
+ConvexHullCore::ConvexHullCore(Dcel *dcel, StepCallback onStep) : ConvexHullCore(nullptr, dcel->getNumberVertices(), dcel, onStep){
+}
+
+/**
+* @brief ConvexHullCore::ConvexHullCore()
+* This method is the constructor the class used without a input mesh. Receive as input a contiguous
+* array of numberPoints points, the pointer of the dcel that will contain the convex hull
+* and the (optional) callback called after every inserted point. The other constructors delegate to this one, the
+* only one that initializes the members
+*/
+ConvexHullCore::ConvexHullCore(const Pointd* points, int numberPoints, Dcel *dcel, StepCallback onStep){
 
     this -> dcel         = dcel;
-    this -> numberVertex = dcel->getNumberVertices();
-    this -> vertexS      = std::vector<Dcel::Vertex*>(numberVertex);
-    this -> mainWindow   = mainWindow;
+    this -> points       = points;
+    this -> numberVertex = numberPoints;
+    this -> inputPoints  = nullptr;
+    this -> slabIndexs   = nullptr;
+    this -> onStep       = onStep;
+    this -> visibleEpoch = 0;
+    this -> numberThreads = 1;
+    this -> strategy     = INCREMENTAL;
+    this -> interiorCulling = false;
+    this -> insertionOrder = RANDOM_ORDER;
+    this -> randomSeed   = DEFAULT_RANDOM_SEED;
+    this -> locationHint = nullptr;
+    this -> cancelFlag   = nullptr;
+    this -> insertionLog = nullptr;
+    this -> trackedUpdate = nullptr;
+
+}
 
+/**
+* @brief ConvexHullCore::ConvexHullCore()
+* This method is the constructor the class used with the points of an array of coordinates (for example a
+* PointCloudFile mapped in memory, see PointSpan): the coordinates are read directly from the span, that must
+* stay valid until the end of findConvexHull()
+*/
+ConvexHullCore::ConvexHullCore(const PointSpan& span, Dcel *dcel, StepCallback onStep) : ConvexHullCore(nullptr, span.numberPoints, dcel, onStep){
+    this -> span = span;
 }
 
 /**
@@ -51,65 +85,730 @@ bool ConvexHullCore::verifyEuleroProperty() const {
 
 /**
  * @brief ConvexHullCore::getVertexs()
- * This method is executed to get all the vertex of the dcel
+ * This method is executed to get all the input points: the array or the span passed to the constructor are only
+ * referenced, while the coordinates of the vertices of the dcel are copied (the dcel will be reset). vertexS
+ * contains the indexs of the points, in the order in which the algorithm processes them
  */
 void ConvexHullCore::getVertexs(){
+    CH_TRACE("getVertexs");
+
+    inputPoints = points;
+    inputSpan   = span;
+    int numberPoints = numberVertex;
+
+    //Se i punti non sono stati passati direttamente vengono letti dalla dcel, copiando solo le coordinate
+    if(points == nullptr && span.empty()){
+        numberPoints = dcel->getNumberVertices();
+        inputCoordinates.resize(3 * numberPoints);
+        int i = 0;
+        for(Dcel::VertexIterator vit = dcel->vertexBegin(); vit != dcel->vertexEnd(); ++vit, i+=3){
+            Pointd p = (*vit)->getCoordinate();
+            inputCoordinates[i]   = p.x();
+            inputCoordinates[i+1] = p.y();
+            inputCoordinates[i+2] = p.z();
+        }
+        inputSpan = PointSpan(inputCoordinates.data(), numberPoints);
+    }
 
-    //Scorro tutti i vertici della dcel e gli salvo in un vettore perchè successivmante la dcel verrà resettata
-    std::vector<Dcel::Vertex*>::iterator vectIt = vertexS.begin();
-    for(Dcel::VertexIterator vit = dcel->vertexBegin(); vit != dcel->vertexEnd(); ++vit,++vectIt){
-        *vectIt = new Dcel::Vertex(**vit);
+    vertexS.resize(numberPoints);
+    if(slabIndexs != nullptr){
+        std::copy(slabIndexs, slabIndexs + numberPoints, vertexS.begin());
+    }else{
+        std::iota(vertexS.begin(), vertexS.end(), 0);
     }
+}
 
+/**
+ * @brief ConvexHullCore::releaseVertexs()
+ * This method release the indexs and the copies of the input points, they are not needed once the convex hull is
+ * in the dcel
+ */
+void ConvexHullCore::releaseVertexs(){
+    vertexS.clear();
+    inputPoints = nullptr;
+    inputSpan   = PointSpan();
+    std::vector<double>().swap(inputCoordinates);
+    std::vector<Pointd>().swap(subHullPoints);
 }
 
 /**
- * @brief ConvexHull::isCoplanar()
- * This method is execut to verify if the 4 points are coplanar
- * @return True if all the 4 points are coplanar, false otherwise
- * http://mathworld.wolfram.com/Coplanar.html
- * In this method is used eigen library, it can easily perform the
- * determinant of a matrix
+ * @brief ConvexHullCore::assignPointBuffer()
+ * This method copy the coordinates of the points in vertexS, in their order, in the SoA buffer used by the kernels
  */
-bool ConvexHullCore::areCoplanar() const{
+void ConvexHullCore::assignPointBuffer(){
+    pointBuffer.assign(vertexS.size(), [this](int i){ return getPoint(i); });
+}
 
-    //Recupero i primi 4 punti che formeranno il tetraedero
-    Pointd p0= vertexS[0] -> getCoordinate();
-    Pointd p1= vertexS[1] -> getCoordinate();
-    Pointd p2= vertexS[2] -> getCoordinate();
-    Pointd p3= vertexS[3] -> getCoordinate();
+/**
+ * @brief ConvexHullCore::getInputIndex()
+ * This method return the index in the input of the i-th point of vertexS, or -1 if vertexS does not refer to the
+ * input points (the vertices of the convex hulls of the slabs, the points of the online convex hull)
+ */
+int ConvexHullCore::getInputIndex(int i) const{
+    if(i >= (int) vertexS.size() || (inputPoints != nullptr && inputPoints != points)){
+        return -1;
+    }
+    return vertexS[i];
+}
 
-    //Matrice Eigen che conterra i primi 4 punti
-    Eigen::Matrix<double,4,4> matrix;
-    matrix<< p0.x(), p0.y(), p0.z(), 1,
-             p1.x(), p1.y(), p1.z(), 1,
-             p2.x(), p2.y(), p2.z(), 1,
-             p3.x(), p3.y(), p3.z(), 1;
+/**
+ * @brief ConvexHullCore::isFullDimensional()
+ * This method is executed to verify that the points are not all coplanar (so their convex hull is a polyhedron),
+ * getPoint(i) returns the i-th one
+ * @return True if there are 4 points not coplanar, false otherwise
+ */
+template <class PointAccessor>
+bool ConvexHullCore::isFullDimensional(int numberPoints, const PointAccessor& getPoint){
 
-    //CAlcolo il determiante della matrice, mi serve per sapere se i punti sono coplanari
-    // il requisito è che i punti non siano coplanari
-    double det = matrix.determinant();
+    if(numberPoints < 4){
+        return false;
+    }
 
-    if(det > std::numeric_limits<double>::epsilon() || det < -std::numeric_limits<double>::epsilon()){
-        return false; //zucchero sintattico, fa un return 0
-    }else{
-        return true; // fa un return 1
+    //Scelgo un triangolo il più grande possibile: p1 il punto più lontano da p0, p2 quello più lontano dalla retta p0 p1
+    Pointd p0 = getPoint(0);
+    int i1 = 0, i2 = 0;
+    double best = 0.0;
+    for(int i=1; i<numberPoints; i++){
+        double distance = (getPoint(i) - p0).getLength();
+        if(distance > best){
+            best = distance;
+            i1   = i;
+        }
     }
+    Pointd p1 = getPoint(i1);
+    best = 0.0;
+    for(int i=1; i<numberPoints; i++){
+        double area = (p1 - p0).cross(getPoint(i) - p0).getLength();
+        if(area > best){
+            best = area;
+            i2   = i;
+        }
+    }
+    if(i1 == 0 || i2 == 0){
+        return false;
+    }
+    Pointd p2 = getPoint(i2);
+
+    //Se il triangolo è degenere tutti gli orientamenti sono nulli e i punti vengono considerati coplanari
+    for(int i=1; i<numberPoints; i++){
+        if(Predicates::orient3d(p0, p1, p2, getPoint(i)) != 0.0){
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief ConvexHullCore::cullInteriorVertexs()
+ * This method is the Akl-Toussaint heuristic: the points extreme along fixed directions (see getExtremePolytope())
+ * are vertices of the convex hull, so every point strictly inside their polytope is not.
+ * These points are removed from vertexS before the permutation, so they never enter the conflict graph.
+ * A point is removed only if the plane values are below minus their error bound for every face of the
+ * polytope, so the removed points are certainly interior and the result does not change
+ */
+void ConvexHullCore::cullInteriorVertexs(){
+    CH_TRACE("cullInteriorVertexs");
+
+    int numberPoints = vertexS.size();
+    if(numberPoints < 4){
+        return;
+    }
+
+    assignPointBuffer();
+    std::vector<FacePlane> interiorPlanes;
+    if(!getExtremePolytope(pointBuffer, pointBuffer.getMaxAbsCoordinate(), interiorPlanes)){
+        return;
+    }
+    std::vector<int> interior, stillInterior;
+    unsigned long long tests = 0;
+    int numberInterior = findInteriorPoints(interiorPlanes, pointBuffer, interior, stillInterior, tests);
+    CH_STATS(stats.orientationTests += tests);
+    if(numberInterior == 0){
+        return;
+    }
+
+    //Compattazione di vertexS: i punti interni vengono eliminati, gli altri mantengono il loro ordine
+    std::vector<bool> isInterior(numberPoints, false);
+    for(int i=0; i<numberInterior; i++){
+        isInterior[interior[i]] = true;
+    }
+    int kept = 0;
+    for(int i=0; i<numberPoints; i++){
+        if(!isInterior[i]){
+            vertexS[kept++] = vertexS[i];
+        }
+    }
+    vertexS.resize(kept);
+    CH_STATS(stats.culledPoints = numberInterior);
+}
+
+/**
+ * @brief ConvexHullCore::getExtremePolytope()
+ * This method compute the convex hull of the points extreme along 26 fixed directions (the axes and the
+ * diagonals of the faces and of the cube) and return the planes of its faces with the sign changed, so that the value of a plane
+ * is positive on the inner side of the face (the planes used by findInteriorPoints()). The error bounds of the
+ * planes hold for the points with coordinates not bigger than maxAbsCoordinate
+ * @return False if the extreme points are coplanar (there is no polytope), true otherwise
+ */
+bool ConvexHullCore::getExtremePolytope(const PointBuffer& points, double maxAbsCoordinate, std::vector<FacePlane>& interiorPlanes){
+
+    interiorPlanes.clear();
+    int numberPoints = points.size();
+    if(numberPoints < 4){
+        return false;
+    }
+
+    //Punti estremi lungo le direzioni fisse (assi, diagonali delle facce e del cubo), in un solo passaggio sul buffer SoA
+    static const int NUMBER_DIRECTIONS = 26;
+    static const double DIRECTIONS[NUMBER_DIRECTIONS][3] = {
+        { 1, 0, 0}, {-1, 0, 0}, { 0, 1, 0}, { 0,-1, 0}, { 0, 0, 1}, { 0, 0,-1},
+        { 1, 1, 0}, {-1,-1, 0}, { 1,-1, 0}, {-1, 1, 0}, { 1, 0, 1}, {-1, 0,-1},
+        { 1, 0,-1}, {-1, 0, 1}, { 0, 1, 1}, { 0,-1,-1}, { 0, 1,-1}, { 0,-1, 1},
+        { 1, 1, 1}, {-1,-1,-1}, { 1, 1,-1}, {-1,-1, 1}, { 1,-1, 1}, {-1, 1,-1}, {-1, 1, 1}, { 1,-1,-1}
+    };
+    const double* x = points.getX();
+    const double* y = points.getY();
+    const double* z = points.getZ();
+    int extreme[NUMBER_DIRECTIONS];
+    double best[NUMBER_DIRECTIONS];
+    for(int d=0; d<NUMBER_DIRECTIONS; d++){
+        extreme[d] = 0;
+        best[d]    = DIRECTIONS[d][0]*x[0] + DIRECTIONS[d][1]*y[0] + DIRECTIONS[d][2]*z[0];
+    }
+    for(int i=1; i<numberPoints; i++){
+        for(int d=0; d<NUMBER_DIRECTIONS; d++){
+            double value = DIRECTIONS[d][0]*x[i] + DIRECTIONS[d][1]*y[i] + DIRECTIONS[d][2]*z[i];
+            if(value > best[d]){
+                best[d]    = value;
+                extreme[d] = i;
+            }
+        }
+    }
+
+    //Polytope degli estremi (il loro convex hull), se non è un poliedro non si scarta nulla
+    std::vector<int> extremeIndexs(extreme, extreme + NUMBER_DIRECTIONS);
+    std::sort(extremeIndexs.begin(), extremeIndexs.end());
+    extremeIndexs.erase(std::unique(extremeIndexs.begin(), extremeIndexs.end()), extremeIndexs.end());
+    std::vector<Pointd> extremePoints;
+    for(unsigned int i=0; i<extremeIndexs.size(); i++){
+        extremePoints.push_back(points.getPoint(extremeIndexs[i]));
+    }
+    if(!isFullDimensional(extremePoints.size(), [&](int i){ return extremePoints[i]; })){
+        return false;
+    }
+    Dcel polytope;
+    ConvexHullCore polytopeCore(extremePoints.data(), extremePoints.size(), &polytope);
+    polytopeCore.findConvexHull();
+
+    //Con il piano cambiato di segno i kernel restituiscono proprio i punti con valore minore di -errorBound
+    for(Dcel::FaceIterator fit = polytope.faceBegin(); fit != polytope.faceEnd(); ++fit){
+        Dcel::HalfEdge* halfEdge = (*fit)->getOuterHalfEdge();
+        FacePlane plane = VisibilityKernels::computePlane(halfEdge->getFromVertex()->getCoordinate(),
+                                                          halfEdge->getNext()->getFromVertex()->getCoordinate(),
+                                                          halfEdge->getNext()->getNext()->getFromVertex()->getCoordinate(),
+                                                          maxAbsCoordinate);
+        plane.a = -plane.a;
+        plane.b = -plane.b;
+        plane.c = -plane.c;
+        plane.d = -plane.d;
+        interiorPlanes.push_back(plane);
+    }
+    return true;
+}
+
+/**
+ * @brief ConvexHullCore::findInteriorPoints()
+ * This method write in interior the indexs of the points certainly inside the polytope of the planes (computed by
+ * getExtremePolytope() with a maxAbsCoordinate not smaller than the one of the buffer): the value of every plane
+ * must be above its error bound. buffer is used as temporary storage, tests count the plane evaluations
+ * @return the number of interior points
+ */
+int ConvexHullCore::findInteriorPoints(const std::vector<FacePlane>& interiorPlanes, const PointBuffer& points,
+                                       std::vector<int>& interior, std::vector<int>& buffer, unsigned long long& tests){
+
+    int numberPoints = points.size();
+    if(interiorPlanes.empty() || numberPoints == 0){
+        return 0;
+    }
+    interior.resize(numberPoints);
+    buffer.resize(numberPoints);
+
+    //Dopo ogni faccia restano solo i punti ancora interni a tutte le facce già controllate
+    const FacePlane& first = interiorPlanes[0];
+    int numberInterior = VisibilityKernels::classifyRange(first, points, 0, numberPoints, first.errorBound, interior.data());
+    tests += numberPoints;
+    for(unsigned int i=1; i<interiorPlanes.size() && numberInterior > 0; i++){
+        const FacePlane& plane = interiorPlanes[i];
+        tests += numberInterior;
+        numberInterior = VisibilityKernels::classifyIndices(plane, points, interior.data(), numberInterior, plane.errorBound, buffer.data());
+        interior.swap(buffer);
+    }
+    return numberInterior;
+}
+
+/**
+ * @brief ConvexHullCore::keepSubHullsVertexs()
+ * This method is executed by the PARALLEL_DIVIDE_AND_CONQUER strategy: the points are split in slabs (with the same
+ * number of points) along the longest side of the bounding box and the convex hull of every slab is computed in
+ * parallel. A vertex of the convex hull of all the points is a vertex of the convex hull of its slab too, so only
+ * these vertices are kept in vertexS; the slabs with all the points coplanar are kept as they are.
+ * The slabs are ranges of vertexS, partitioned in place, and every slab reads the input points through their
+ * indexs, so the points are not copied. The convex hull is the same of the serial algorithm, but not always its
+ * vertices: a point on a face or on an edge (not a corner) can be a vertex of both, only of one or of none of them
+ */
+void ConvexHullCore::keepSubHullsVertexs(){
+    CH_TRACE("keepSubHullsVertexs");
+
+    int numberPoints = vertexS.size();
+
+    //Almeno SUBHULL_MIN_POINTS punti per fetta, più fette che thread così il work stealing bilancia le fette più lente.
+    //Il thread pool viene creato solo se le fette sono almeno due
+    const int SUBHULL_MIN_POINTS = 4096;
+    int numberSlabs = std::min(4 * getNumberThreads(), numberPoints / SUBHULL_MIN_POINTS);
+    if(numberSlabs < 2){
+        return;
+    }
+
+    //Asse più lungo del bounding box
+    Pointd minimum = getPoint(0), maximum = minimum;
+    for(int i=1; i<numberPoints; i++){
+        Pointd p = getPoint(i);
+        minimum = minimum.min(p);
+        maximum = maximum.max(p);
+    }
+    Pointd size = maximum - minimum;
+    int axis = (size.x() >= size.y() && size.x() >= size.z()) ? 0 : (size.y() >= size.z() ? 1 : 2);
+
+    //Divisione in fette degli indici di vertexS: ogni nth_element mette al loro posto i punti di confine tra una fetta
+    //e la successiva, la coordinata viene letta dai punti in ingresso
+    std::vector<int> slabBegin(numberSlabs+1);
+    for(int slab=0; slab<=numberSlabs; slab++){
+        slabBegin[slab] = (long long) numberPoints * slab / numberSlabs;
+    }
+    auto key = [this, axis](int index){
+        Pointd p = getInputPoint(index);
+        return axis == 0 ? p.x() : (axis == 1 ? p.y() : p.z());
+    };
+    for(int slab=1; slab<numberSlabs; slab++){
+        std::nth_element(vertexS.begin() + slabBegin[slab-1], vertexS.begin() + slabBegin[slab], vertexS.end(), [&](int a, int b){
+            return key(a) < key(b);
+        });
+    }
+
+    //Convex hull delle fette in parallelo, ognuno con la sua dcel
+    std::vector<std::vector<Pointd> > slabVertexs(numberSlabs);
+    getThreadPool()->parallelFor(0, numberSlabs, 1, [&](int firstSlab, int lastSlab){
+        for(int slab=firstSlab; slab<lastSlab; slab++){
+            CH_TRACE("subHull");
+            const int* slabIndexs = vertexS.data() + slabBegin[slab];
+            int slabSize = slabBegin[slab+1] - slabBegin[slab];
+            if(!isFullDimensional(slabSize, [&](int i){ return getInputPoint(slabIndexs[i]); })){
+                for(int i=0; i<slabSize; i++){
+                    slabVertexs[slab].push_back(getInputPoint(slabIndexs[i]));
+                }
+                continue;
+            }
+            Dcel slabDcel;
+            ConvexHullCore slabCore(&slabDcel);
+            slabCore.setSlab(inputPoints, inputSpan, slabIndexs, slabSize);
+            slabCore.setCancelFlag(cancelFlag);
+            slabCore.setInsertionOrder(insertionOrder);
+            slabCore.setRandomSeed(randomSeed + slab);
+            slabCore.findConvexHull();
+            for(Dcel::VertexIterator vit = slabDcel.vertexBegin(); vit != slabDcel.vertexEnd(); ++vit){
+                slabVertexs[slab].push_back((*vit)->getCoordinate());
+            }
+        }
+    });
+
+    //L'algoritmo incrementale continua solo sull'unione dei vertici, che diventano i punti in ingresso
+    std::vector<Pointd> vertexs;
+    for(int slab=0; slab<numberSlabs; slab++){
+        vertexs.insert(vertexs.end(), slabVertexs[slab].begin(), slabVertexs[slab].end());
+    }
+    releaseVertexs();
+    subHullPoints.swap(vertexs);
+    inputPoints = subHullPoints.data();
+    inputSpan   = PointSpan();
+    vertexS.resize(subHullPoints.size());
+    std::iota(vertexS.begin(), vertexS.end(), 0);
+}
+
+/**
+ * @brief ConvexHullCore::setSlab()
+ * This method is used by keepSubHullsVertexs(): the input points of the next findConvexHull() are only the ones with
+ * the given indexs in the array or in the span, that are read without copying them
+ */
+void ConvexHullCore::setSlab(const Pointd* points, const PointSpan& span, const int* slabIndexs, int numberPoints){
+    this -> points       = points;
+    this -> span         = span;
+    this -> slabIndexs   = slabIndexs;
+    this -> numberVertex = numberPoints;
+}
+
+/**
+ * @brief ConvexHullCore::areCollinear()
+ * This method is executed to verify if the 3 points are on the same line, that is if the projections of the
+ * triangle on the three coordinate planes have all zero area. The orientations are exact
+ * @return True if the 3 points are collinear, false otherwise
+ */
+bool ConvexHullCore::areCollinear(const Pointd& p0, const Pointd& p1, const Pointd& p2){
+    return Predicates::orient2d(p0.x(), p0.y(), p1.x(), p1.y(), p2.x(), p2.y()) == 0.0 &&
+           Predicates::orient2d(p0.y(), p0.z(), p1.y(), p1.z(), p2.y(), p2.z()) == 0.0 &&
+           Predicates::orient2d(p0.z(), p0.x(), p1.z(), p1.x(), p2.z(), p2.x()) == 0.0;
+}
+
+/**
+ * @brief ConvexHullCore::moveToFront()
+ * This method move the vertexs with the given (distinct) indexs in the first positions of vertexS, in order
+ */
+void ConvexHullCore::moveToFront(int* indexs, int number){
+    for(int k=0; k<number; k++){
+        std::swap(vertexS[k], vertexS[indexs[k]]);
+        //Il vertice che stava in posizione k è finito dove stava quello appena spostato
+        for(int j=k+1; j<number; j++){
+            if(indexs[j] == k){
+                indexs[j] = indexs[k];
+            }
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullCore::selectInitialSimplex()
+ * This method is executed to choose the 4 vertexs of the initial tetrahedron among the extreme points: the two
+ * farthest points among the minimum and the maximum along the axes, the point farthest from their line and the
+ * point farthest from the plane of the three. The chosen vertexs are moved in the first 4 positions of vertexS.
+ * If the points are all equal, collinear or coplanar the first 1, 2 or 3 positions contain the vertexs that
+ * span them (for collinear points the two endpoints of the segment)
+ * @return the dimension of the convex hull: 3 for a polyhedron, 2, 1 or 0 for the degenerate inputs, -1 if there are no points
+ */
+int ConvexHullCore::selectInitialSimplex(){
+
+    int numberPoints = vertexS.size();
+    if(numberPoints == 0){
+        return -1;
+    }
+
+    assignPointBuffer();
+    const double* x = pointBuffer.getX();
+    const double* y = pointBuffer.getY();
+    const double* z = pointBuffer.getZ();
+
+    //Minimo e massimo lungo ogni asse
+    int extreme[6] = {0, 0, 0, 0, 0, 0};
+    for(int i=1; i<numberPoints; i++){
+        if(x[i] < x[extreme[0]]) extreme[0] = i;
+        if(x[i] > x[extreme[1]]) extreme[1] = i;
+        if(y[i] < y[extreme[2]]) extreme[2] = i;
+        if(y[i] > y[extreme[3]]) extreme[3] = i;
+        if(z[i] < z[extreme[4]]) extreme[4] = i;
+        if(z[i] > z[extreme[5]]) extreme[5] = i;
+    }
+
+    //I primi due vertici sono la coppia di estremi più lontana, se la distanza è nulla i punti sono tutti uguali
+    int simplex[4] = {0, 0, 0, 0};
+    double best = 0.0;
+    for(int a=0; a<6; a++){
+        for(int b=a+1; b<6; b++){
+            double distance = (pointBuffer.getPoint(extreme[a]) - pointBuffer.getPoint(extreme[b])).getLength();
+            if(distance > best){
+                best       = distance;
+                simplex[0] = extreme[a];
+                simplex[1] = extreme[b];
+            }
+        }
+    }
+    if(best == 0.0){
+        moveToFront(simplex, 1);
+        return 0;
+    }
+
+    //Il terzo è il più lontano dalla retta; se il triangolo è degenere si cerca un qualunque punto non allineato
+    Pointd p0 = pointBuffer.getPoint(simplex[0]);
+    Pointd p1 = pointBuffer.getPoint(simplex[1]);
+    Pointd direction = p1 - p0;
+    best = 0.0;
+    simplex[2] = -1;
+    for(int i=0; i<numberPoints; i++){
+        double area = direction.cross(pointBuffer.getPoint(i) - p0).getLength();
+        if(area > best){
+            best       = area;
+            simplex[2] = i;
+        }
+    }
+    if(simplex[2] < 0 || areCollinear(p0, p1, pointBuffer.getPoint(simplex[2]))){
+        simplex[2] = -1;
+        for(int i=0; i<numberPoints && simplex[2] < 0; i++){
+            if(!areCollinear(p0, p1, pointBuffer.getPoint(i))){
+                simplex[2] = i;
+            }
+        }
+    }
+    if(simplex[2] < 0){
+        //Punti allineati: gli estremi del segmento sono il minimo e il massimo lungo l'asse di estensione maggiore
+        Pointd size = Pointd(x[extreme[1]] - x[extreme[0]], y[extreme[3]] - y[extreme[2]], z[extreme[5]] - z[extreme[4]]);
+        int axis = (size.x() >= size.y() && size.x() >= size.z()) ? 0 : (size.y() >= size.z() ? 1 : 2);
+        simplex[0] = extreme[2*axis];
+        simplex[1] = extreme[2*axis+1];
+        moveToFront(simplex, 2);
+        return 1;
+    }
+
+    //Il quarto è il più lontano dal piano; se l'orientamento esatto è nullo si cerca un qualunque punto fuori dal piano
+    Pointd p2 = pointBuffer.getPoint(simplex[2]);
+    FacePlane plane = VisibilityKernels::computePlane(p0, p1, p2, pointBuffer.getMaxAbsCoordinate());
+    best = 0.0;
+    simplex[3] = -1;
+    for(int i=0; i<numberPoints; i++){
+        double distance = std::fabs(VisibilityKernels::evaluate(plane, pointBuffer, i));
+        if(distance > best){
+            best       = distance;
+            simplex[3] = i;
+        }
+    }
+    CH_STATS(stats.orientationTests += numberPoints);
+    if(simplex[3] < 0 || Predicates::orient3d(p0, p1, p2, pointBuffer.getPoint(simplex[3])) == 0.0){
+        simplex[3] = -1;
+        for(int i=0; i<numberPoints && simplex[3] < 0; i++){
+            CH_STATS(stats.orientationTests++);
+            if(Predicates::orient3d(p0, p1, p2, pointBuffer.getPoint(i)) != 0.0){
+                simplex[3] = i;
+            }
+        }
+    }
+    if(simplex[3] < 0){
+        moveToFront(simplex, 3);
+        return 2;
+    }
+
+    moveToFront(simplex, 4);
+    return 3;
 }
 
 /**
  * @brief ConvexHullCore::getPermutation()
- * This method is executed to execute the permutation of the vertexs
- * http://www.cplusplus.com/reference/algorithm/random_shuffle/
+ * This method is executed to execute the permutation of the vertexs after the first 4, that are the vertexs
+ * of the initial tetrahedron chosen by selectInitialSimplex(), in the insertion order chosen (see
+ * InsertionOrder). The permutation depends only on the seed, so every execution with the same points and the
+ * same seed inserts them in the same order
  */
 void ConvexHullCore::executePermutation(){
+    CH_TRACE("executePermutation");
 
-    //Eseguo la permutazione, in modo da garantire che i punti non siano coplanari
-    do{
-       std::random_shuffle(this->vertexS.begin(), this->vertexS.end());
-    }while(areCoplanar());
+    std::mt19937 random(randomSeed);
+    if(insertionOrder == BRIO_ORDER){
+        executeBiasedPermutation(random);
+    }else{
+        std::shuffle(this->vertexS.begin() + 4, this->vertexS.end(), random);
+    }
+}
+
+/**
+ * @brief ConvexHullCore::executeBiasedPermutation()
+ * This method is the BRIO_ORDER permutation: every point is in the last round with probability 1/2, in the one
+ * before with probability 1/4 and so on, until the first round that has at least BRIO_MIN_ROUND points in
+ * expectation. The rounds are inserted from the first, and the points of every round are sorted along the Morton
+ * curve of the bounding box of the points
+ */
+void ConvexHullCore::executeBiasedPermutation(std::mt19937& random){
+
+    int numberPoints = vertexS.size() - 4;
+    if(numberPoints <= 1){
+        return;
+    }
+
+    //Numero di round oltre il primo: il primo round contiene in media numberPoints / 2^lastRound punti
+    int lastRound = 0;
+    while(lastRound < 30 && (numberPoints >> (lastRound+1)) >= BRIO_MIN_ROUND){
+        lastRound++;
+    }
+
+    //Bounding box dei punti, quantizzata a 21 bit per asse nel codice di Morton
+    Pointd min = getPoint(4), max = getPoint(4);
+    for(int i=5; i<(int)vertexS.size(); i++){
+        Pointd p = getPoint(i);
+        min = Pointd(std::min(min.x(), p.x()), std::min(min.y(), p.y()), std::min(min.z(), p.z()));
+        max = Pointd(std::max(max.x(), p.x()), std::max(max.y(), p.y()), std::max(max.z(), p.z()));
+    }
+    const double CELLS = (1 << 21) - 1;
+    Pointd extent = max - min;
+    Pointd scale(extent.x() > 0 ? CELLS / extent.x() : 0, extent.y() > 0 ? CELLS / extent.y() : 0, extent.z() > 0 ? CELLS / extent.z() : 0);
+
+    //I punti vengono ordinati per round (prima i round con indice minore) e, nello stesso round, per codice di Morton
+    struct Key{
+        int round;
+        unsigned long long code;
+        int index;
+    };
+    std::vector<Key> keys(numberPoints);
+    for(int i=0; i<numberPoints; i++){
+        //Il round si sceglie con lanci di moneta: ogni testa sposta il punto di un round verso il primo
+        int round = lastRound;
+        while(round > 0 && (random() & 1)){
+            round--;
+        }
+        keys[i].round = round;
+        keys[i].code  = getMortonCode(getPoint(i+4), min, scale);
+        keys[i].index = vertexS[i+4];
+    }
+    std::sort(keys.begin(), keys.end(), [](const Key& a, const Key& b){
+        return a.round != b.round ? a.round < b.round : a.code < b.code;
+    });
+    for(int i=0; i<numberPoints; i++){
+        vertexS[i+4] = keys[i].index;
+    }
+}
+
+/**
+ * @brief ConvexHullCore::getMortonCode()
+ * This method return the position of the point along the Morton curve: the coordinates, quantized to 21 bits in the
+ * bounding box (min and the number of cells per unit of every axis), are interleaved bit by bit
+ */
+unsigned long long ConvexHullCore::getMortonCode(const Pointd& point, const Pointd& min, const Pointd& scale){
+
+    unsigned long long code = 0;
+    unsigned long long cells[3] = {
+        (unsigned long long) ((point.x() - min.x()) * scale.x()),
+        (unsigned long long) ((point.y() - min.y()) * scale.y()),
+        (unsigned long long) ((point.z() - min.z()) * scale.z())
+    };
+    for(int axis=0; axis<3; axis++){
+        //Ogni bit della coordinata va in posizione 3*bit + asse
+        unsigned long long x = cells[axis] & 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffffULL;
+        x = (x | x << 16) & 0x1f0000ff0000ffULL;
+        x = (x | x << 8)  & 0x100f00f00f00f00fULL;
+        x = (x | x << 4)  & 0x10c30c30c30c30c3ULL;
+        x = (x | x << 2)  & 0x1249249249249249ULL;
+        code |= x << axis;
+    }
+    return code;
+}
+
+/**
+ * @brief ConvexHullCore::setDegenerateHull()
+ * This method is executed when the points are not full dimensional: the dcel will contain the only point,
+ * the segment (two twin half edges without faces) or the polygon between the points (see setPolygon())
+ */
+void ConvexHullCore::setDegenerateHull(int dimension){
+
+    if(dimension == 0){
+        dcel->addVertex(getPoint(0));
+    }else if(dimension == 1){
+        Dcel::Vertex* v1 = dcel->addVertex(getPoint(0));
+        Dcel::Vertex* v2 = dcel->addVertex(getPoint(1));
+        Dcel::HalfEdge* halfEdge1 = dcel->addHalfEdge();
+        Dcel::HalfEdge* halfEdge2 = dcel->addHalfEdge();
+        halfEdge1 -> setFromVertex(v1);
+        halfEdge1 -> setToVertex(v2);
+        halfEdge1 -> setTwin(halfEdge2);
+        halfEdge1 -> setNext(halfEdge2);
+        halfEdge1 -> setPrev(halfEdge2);
+        halfEdge2 -> setFromVertex(v2);
+        halfEdge2 -> setToVertex(v1);
+        halfEdge2 -> setTwin(halfEdge1);
+        halfEdge2 -> setNext(halfEdge1);
+        halfEdge2 -> setPrev(halfEdge1);
+        v1 -> setIncidentHalfEdge(halfEdge1);
+        v2 -> setIncidentHalfEdge(halfEdge2);
+        v1 -> incrementCardinality();
+        v2 -> incrementCardinality();
+        v1 -> incrementCardinality();
+        v2 -> incrementCardinality();
+    }else if(dimension == 2){
+        setPolygon();
+    }
 }
 
+/**
+ * @brief ConvexHullCore::setPolygon()
+ * This method is executed when all the points are coplanar (the first 3 vertexs of vertexS are not collinear).
+ * The points are projected on the coordinate plane where the normal of their plane has the biggest component,
+ * their convex polygon is found with the monotone chain (exact orientations, the collinear points on the boundary
+ * are discarded) and it is saved in the dcel as a flat closed surface: a fan of triangles for every side
+ */
+void ConvexHullCore::setPolygon(){
+
+    Pointd p0 = getPoint(0);
+    Pointd normal = (getPoint(1) - p0).cross(getPoint(2) - p0);
+    int axis = (std::fabs(normal.x()) >= std::fabs(normal.y()) && std::fabs(normal.x()) >= std::fabs(normal.z())) ? 0 :
+               (std::fabs(normal.y()) >= std::fabs(normal.z()) ? 1 : 2);
+
+    //Coordinate dei punti proiettati, eliminando l'asse scelto
+    int numberPoints = vertexS.size();
+    std::vector<double> u(numberPoints), v(numberPoints);
+    for(int i=0; i<numberPoints; i++){
+        Pointd p = getPoint(i);
+        u[i] = axis == 0 ? p.y() : (axis == 1 ? p.z() : p.x());
+        v[i] = axis == 0 ? p.z() : (axis == 1 ? p.x() : p.y());
+    }
+
+    //Monotone chain: catena inferiore e superiore sui punti ordinati per (u, v)
+    std::vector<int> order(numberPoints);
+    for(int i=0; i<numberPoints; i++){
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b){
+        return u[a] < u[b] || (u[a] == u[b] && v[a] < v[b]);
+    });
+    std::vector<int> polygon(2*numberPoints);
+    int size = 0;
+    for(int i=0; i<numberPoints; i++){
+        int point = order[i];
+        while(size >= 2 && Predicates::orient2d(u[polygon[size-2]], v[polygon[size-2]], u[polygon[size-1]], v[polygon[size-1]], u[point], v[point]) <= 0.0){
+            size--;
+        }
+        polygon[size++] = point;
+    }
+    for(int i=numberPoints-2, lower=size+1; i>=0; i--){
+        int point = order[i];
+        while(size >= lower && Predicates::orient2d(u[polygon[size-2]], v[polygon[size-2]], u[polygon[size-1]], v[polygon[size-1]], u[point], v[point]) <= 0.0){
+            size--;
+        }
+        polygon[size++] = point;
+    }
+    polygon.resize(size-1);
+
+    //Vertici del poligono e triangoli a ventaglio: sul davanti dal primo vertice, sul retro dal secondo e con il giro
+    //invertito, così ogni diagonale appartiene ad un solo lato e ogni lato ha esattamente due facce
+    int numberVertexs = polygon.size();
+    std::vector<Dcel::Vertex*> vertexs(numberVertexs);
+    for(int i=0; i<numberVertexs; i++){
+        vertexs[i] = dcel->addVertex(getPoint(polygon[i]));
+    }
+    std::vector<int> triangles;
+    for(int i=1; i+1<numberVertexs; i++){
+        int front[3] = {0, i, i+1};
+        int back[3]  = {1, (i+2) % numberVertexs, i+1};
+        triangles.insert(triangles.end(), front, front+3);
+        triangles.insert(triangles.end(), back, back+3);
+    }
+
+    //Creazione delle facce, i twin vengono trovati con la coppia (from, to) degli half edge
+    std::map<std::pair<int, int>, Dcel::HalfEdge*> halfEdges;
+    for(unsigned int t=0; t<triangles.size(); t+=3){
+        Dcel::Face* face = dcel->addFace();
+        Dcel::HalfEdge* halfEdge[3] = {dcel->addHalfEdge(), dcel->addHalfEdge(), dcel->addHalfEdge()};
+        face -> setOuterHalfEdge(halfEdge[0]);
+        for(int k=0; k<3; k++){
+            Dcel::Vertex* from = vertexs[triangles[t+k]];
+            Dcel::Vertex* to   = vertexs[triangles[t+(k+1)%3]];
+            halfEdge[k] -> setFromVertex(from);
+            halfEdge[k] -> setToVertex(to);
+            halfEdge[k] -> setFace(face);
+            halfEdge[k] -> setNext(halfEdge[(k+1)%3]);
+            halfEdge[k] -> setPrev(halfEdge[(k+2)%3]);
+            from -> setIncidentHalfEdge(halfEdge[k]);
+            from -> incrementCardinality();
+            to   -> incrementCardinality();
+            halfEdges[std::make_pair(triangles[t+k], triangles[t+(k+1)%3])] = halfEdge[k];
+        }
+    }
+    for(std::map<std::pair<int, int>, Dcel::HalfEdge*>::iterator it = halfEdges.begin(); it != halfEdges.end(); ++it){
+        it->second->setTwin(halfEdges[std::make_pair(it->first.second, it->first.first)]);
+    }
+}
 
 /**
  * @brief ConvexHullCore::setTetrahedron
@@ -117,23 +816,24 @@ void ConvexHullCore::executePermutation(){
  * the execution of setTetrahedron() the dcel contain the convex hull of the 4 initial points
  */
 void ConvexHullCore::setTetrahedron(){
+    CH_TRACE("setTetrahedron");
 
     //Conterrà gli half edge del triangolo che verranno usati per costruire il tetraedro
-    std::list<Dcel::HalfEdge *> horizon;
+    std::vector<Dcel::HalfEdge *> horizon;
 
     //Aggiunta dei vertici nella dcel
     Dcel::Vertex* v1;
-    Dcel::Vertex* v2 = this->dcel->addVertex(this->vertexS[1]->getCoordinate());
+    Dcel::Vertex* v2 = this->dcel->addVertex(getPoint(1));
     Dcel::Vertex* v3;
-    Dcel::Vertex* v4 = this->dcel->addVertex(this->vertexS[3]->getCoordinate());
+    Dcel::Vertex* v4 = this->dcel->addVertex(getPoint(3));
 
     //Se la faccia del trinagolo, ha la normale rivolta verso il punto, allora faccio uno switch, in modo da garantire il senso antiorario degli he
     if(isNormalFaceTurnedTowardsThePoint()){
-        v3 = this->dcel->addVertex(this->vertexS[0]->getCoordinate());
-        v1 = this->dcel->addVertex(this->vertexS[2]->getCoordinate());
+        v3 = this->dcel->addVertex(getPoint(0));
+        v1 = this->dcel->addVertex(getPoint(2));
     }else{
-        v1 = this->dcel->addVertex(this->vertexS[0]->getCoordinate());
-        v3 = this->dcel->addVertex(this->vertexS[2]->getCoordinate());
+        v1 = this->dcel->addVertex(getPoint(0));
+        v3 = this->dcel->addVertex(getPoint(2));
     }
 
     //Creo gli half edge del triangolo
@@ -173,159 +873,463 @@ void ConvexHullCore::setTetrahedron(){
     v3 -> incrementCardinality();
     v1 -> incrementCardinality();
 
-    //Inserimento degli half edge nella lista horizon, su cui costruire le altre facce
+    //Inserimento degli half edge nell'orizzonte, su cui costruire le altre facce
     horizon.push_back(halfEdge1);
     horizon.push_back(halfEdge2);
     horizon.push_back(halfEdge3);
 
     //Creazione delle altre tre facce che formano il tetraedro
-    createNewFaces(horizon, v4);
+    std::vector<Dcel::Face*> newFaces;
+    createNewFaces(horizon, v4, newFaces);
 
 }
 
 /**
- * @brief ConvexHullCore::getHorizon()
- * This method is executed to find the horizon by a faces visible by a vertex
- * This method, return a horizon list
+ * @brief ConvexHullCore::insertFarthestPoints()
+ * This method is the QUICKHULL strategy: every point outside the convex hull is in the outside set of one of the
+ * faces that it sees, and at every step the farthest of these points is inserted. The faces visible by the point
+ * are found visiting the neighbours of its face, then the horizon and the new faces are built as in the
+ * incremental algorithm; the points of the removed faces are assigned to the new faces (or discarded if interior)
  */
-std::list<Dcel::HalfEdge*> ConvexHullCore::getHorizon(std::set<Dcel::Face *> *facesVisibleByVertex) const {
+void ConvexHullCore::insertFarthestPoints(){
 
-    /* L'idea di questo metodo è di scorrere le facce visibili dal punto. Si scorre la faccia mediante i suoi half edge,
-     * si verifica se il twin dell'half edge corrente (l'half edge della faccia visibile) appartenga ad una faccia non
-     * visibile dal punto, se così fosse, allora questo twin dell'half edge della faccia visibile fa parte dell'orizzonte.
-     * Una volta computate tutte le facce abbiamo un insieme di half edge non ordinati. Per ordinarli, mi servo di una mappa
-     * da FromVertex a half edge, in questo modo posso ordinare l'horizzonte. Partendo da un half edge qualunque dell'orizzonte,
-     * il successivo sarà mappa[edge->getToVertex()]. Dato che è una hash map ogni accesso è in O(1)
-     */
+    //Le coordinate vengono copiate nel buffer SoA, per i kernel che assegnano i punti alle facce
+    assignPointBuffer();
+    //Gli insiemi esterni restano tra un'esecuzione e l'altra, così i loro vector non vengono riallocati
+    if(farthestOutsideSets == nullptr){
+        farthestOutsideSets.reset(new OutsideSets(this->dcel, this->pointBuffer, &this->stats));
+    }
+    farthestOutsideSets -> clear();
+    farthestOutsideSets -> initialize();
+    if(onPhase) onPhase("initializeOutsideSets");
+
+    expandFarthestPoints(*farthestOutsideSets, trackedUpdate);
+    if(onPhase) onPhase("insertion");
+}
+
+/**
+ * @brief ConvexHullCore::expandFarthestPoints()
+ * This method insert the farthest point of the outside sets until they are empty. If update is not null the
+ * faces removed and added by the insertions are recorded there
+ */
+void ConvexHullCore::expandFarthestPoints(OutsideSets& outsideSets, Update* update){
+
+    //Buffer riusati ad ogni passo
+    std::vector<Dcel::Face*> facesVisibleByVertex;
+    std::vector<Dcel::HalfEdge*> horizon;
+    std::vector<Dcel::Face*> newFaces;
+    std::vector<int> orphans;
+
+    //Il progresso è la frazione dei punti esterni iniziali già inseriti o scartati
+    const int PROGRESS_INTERVAL = 256;
+    int initialOutsidePoints = outsideSets.getNumberPoints();
+    int insertedPoints = 0;
+
+    Dcel::Face* face;
+    int point;
+    while(!isCancelled() && outsideSets.getFarthestPoint(face, point)){
+        CH_TRACE("insertPoint");
+
+        //Facce visibili dal punto, a partire da quella a cui è assegnato
+        getFacesVisibleFromFace(point, face, outsideSets, facesVisibleByVertex);
+
+        //Inserimento punto nella dcel e ricerca dell'orizzonte
+        Dcel::Vertex* currentVertex = dcel->addVertex(pointBuffer.getPoint(point));
+        getHorizon(facesVisibleByVertex, horizon);
+        CH_STATS(stats.insertedPoints++);
+        CH_STATS(ConvexHullStats::addToHistogram(stats.visibleFacesHistogram, facesVisibleByVertex.size()));
+        CH_STATS(ConvexHullStats::addToHistogram(stats.horizonHistogram, horizon.size()));
+
+        //I punti delle facce visibili vanno riassegnati, poi le facce vengono rimosse e sostituite dalle nuove
+        outsideSets.takePoints(facesVisibleByVertex, point, orphans);
+        if(update) trackRemovedFaces(facesVisibleByVertex, *update);
+        if(insertionLog) insertionLog->beginStep(getInputIndex(point), facesVisibleByVertex);
+        removeFacesVisibleByVertex(facesVisibleByVertex);
+        createNewFaces(horizon, currentVertex, newFaces);
+        if(insertionLog) insertionLog->endStep(currentVertex, horizon, newFaces);
+        if(update) trackAddedFaces(newFaces, *update);
+        outsideSets.assignPoints(newFaces, orphans);
+        locationHint = newFaces[0];
+
+        if(onStep){
+            onStep();
+        }
+        if(onProgress && ++insertedPoints % PROGRESS_INTERVAL == 0 && initialOutsidePoints > 0){
+            onProgress(1.0 - (double) outsideSets.getNumberPoints() / initialOutsidePoints);
+        }
+    }
+}
 
-    std::set<Dcel::HalfEdge*> horizonUnordered;
-    std::list<Dcel::HalfEdge*> horizonOrdered;
-    std::map<Dcel::Vertex*, Dcel::HalfEdge*> hm;
+/**
+ * @brief ConvexHullCore::insertPoints()
+ * This method is the online convex hull: the points are added to the convex hull built by the previous calls
+ * (the first call reset the dcel). Every new point is located with a walk on the faces (see
+ * OutsideSets::locatePoint()), the interior ones are discarded and the others are inserted as in the QUICKHULL
+ * strategy, so only the region of the convex hull that changes is visited. Until the points are all coplanar
+ * they are kept aside and the dcel contains their degenerate convex hull (see setDegenerateHull()).
+ * If update is not null it receive the ids of the faces removed and added by the call
+ */
+void ConvexHullCore::insertPoints(const Pointd* points, int numberPoints, Update* update){
 
-    //Scorro le facce visibili dal punto
-    for(std::set<Dcel::Face*>::iterator fit = facesVisibleByVertex->begin(); fit != facesVisibleByVertex->end(); ++fit){
-        Dcel::Face* currentFace = *fit;
+    if(update){
+        update->addedFaces.clear();
+        update->removedFaces.clear();
+    }
+    if(numberPoints <= 0){
+        return;
+    }
 
-        Dcel::HalfEdge* outerHE = currentFace -> getOuterHalfEdge();
-        Dcel::HalfEdge* twin    = outerHE     -> getTwin();
+    if(onlineOutsideSets == nullptr){
+        buildOnlineHull(points, numberPoints, update);
+        return;
+    }
 
-        //Per ogni faccia scorro gli half edge della faccia
-        for(int i=0;i<3;i++){
-            Dcel::Face* faceTwin = twin -> getFace();
+    //I punti delle chiamate precedenti sono già tutti inseriti o scartati, il buffer contiene solo quelli nuovi
+    pointBuffer.clear();
+    pointBuffer.append(points, numberPoints);
+    onlineOutsideSets -> refreshPlanes();
+    for(int point=0; point<numberPoints; point++){
+        //I punti vicini tra loro hanno facce vicine, la ricerca parte dall'ultima faccia trovata
+        Dcel::Face* face = onlineOutsideSets -> locatePoint(point, locationHint);
+        if(face != nullptr){
+            onlineOutsideSets -> addPoint(point, face);
+            locationHint = face;
+        }
+    }
+    expandFarthestPoints(*onlineOutsideSets, update);
+    if(update){
+        finishUpdate(*update);
+    }
+}
 
-            //se il twin dell'HE sta in una faccia non visibile, allora HE è proprio nell'orizzonte
-            if(facesVisibleByVertex->count(faceTwin) == 0){
-                horizonUnordered.insert(twin);
-            }
+/**
+ * @brief ConvexHullCore::buildOnlineHull()
+ * This method is executed by insertPoints() until the points are full dimensional: the new points are added to
+ * the ones kept aside and the convex hull of all of them is rebuilt in the dcel. Once the initial tetrahedron
+ * exists the outside sets are created, and from now on the points are inserted in the existing convex hull
+ */
+void ConvexHullCore::buildOnlineHull(const Pointd* points, int numberPoints, Update* update){
+
+    //Le facce del convex hull degenere precedente vengono tutte sostituite
+    if(update){
+        for(Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit){
+            update->removedFaces.push_back((*fit)->getId());
+        }
+    }
 
-            outerHE = outerHE -> getNext();
-            twin    = outerHE -> getTwin();
+    pendingPoints.insert(pendingPoints.end(), points, points + numberPoints);
+    releaseVertexs();
+    inputPoints = pendingPoints.data();
+    vertexS.resize(pendingPoints.size());
+    std::iota(vertexS.begin(), vertexS.end(), 0);
+    this -> dcel -> reset();
+    this -> visibleEpoch = 0;
+
+    int dimension = selectInitialSimplex();
+    if(dimension < 3){
+        //Il convex hull dei punti accantonati è quello dei vertici del convex hull degenere, solo questi vengono
+        //tenuti: con un input lungo e complanare la memoria non cresce con il numero dei punti
+        setDegenerateHull(dimension);
+        if(insertionLog) insertionLog->setInitialHull(*dcel);
+        pendingPoints.clear();
+        for(Dcel::VertexIterator vit = dcel->vertexBegin(); vit != dcel->vertexEnd(); ++vit){
+            pendingPoints.push_back((*vit)->getCoordinate());
         }
+    }else{
+        //Il baricentro del tetraedro iniziale resta interno al convex hull, serve per localizzare i nuovi punti
+        setTetrahedron();
+        if(insertionLog) insertionLog->setInitialHull(*dcel);
+        Pointd interiorPoint = (getPoint(0) + getPoint(1) + getPoint(2) + getPoint(3)) / 4.0;
+        assignPointBuffer();
+        pendingPoints.clear();
+        onlineOutsideSets.reset(new OutsideSets(this->dcel, this->pointBuffer, &this->stats));
+        onlineOutsideSets -> setInteriorPoint(interiorPoint);
+        onlineOutsideSets -> initialize();
+        locationHint = *dcel->faceBegin();
+        expandFarthestPoints(*onlineOutsideSets, nullptr);
+    }
+    releaseVertexs();
 
+    if(update){
+        for(Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit){
+            update->addedFaces.push_back((*fit)->getId());
+        }
     }
+}
 
-    //Carico la mappa che userò per ordinare gli HE dell'orizzonte
-    for(std::set<Dcel::HalfEdge*>::iterator heit= horizonUnordered.begin(); heit!= horizonUnordered.end() ; ++heit){
-        Dcel::HalfEdge* he= *heit;
-        hm[he->getFromVertex()]=he;
+/**
+ * @brief ConvexHullCore::trackRemovedFaces()
+ * This method record the removed faces in the update: the faces added and removed by the same call are not reported
+ */
+void ConvexHullCore::trackRemovedFaces(const std::vector<Dcel::Face*>& faces, Update& update){
+    for(std::vector<Dcel::Face*>::const_iterator fit = faces.begin(); fit != faces.end(); ++fit){
+        unsigned int faceId = (*fit)->getId();
+        if(faceId < addedInUpdate.size() && addedInUpdate[faceId]){
+            addedInUpdate[faceId] = 0;
+        }else{
+            update.removedFaces.push_back(faceId);
+        }
     }
+}
 
-    //Ordino gli HE dell'orizzonte
-    int count=0;
-    for(std::set<Dcel::HalfEdge*>::iterator heit= horizonUnordered.begin(); heit!= horizonUnordered.end() ; ++heit){
-        Dcel::HalfEdge* he;//il precedente
-        if(count==0){
-            he= *heit;
-            horizonOrdered.push_back(*heit);
-            count++;
+/**
+ * @brief ConvexHullCore::trackAddedFaces()
+ * This method record the added faces in the update
+ */
+void ConvexHullCore::trackAddedFaces(const std::vector<Dcel::Face*>& faces, Update& update){
+    for(std::vector<Dcel::Face*>::const_iterator fit = faces.begin(); fit != faces.end(); ++fit){
+        unsigned int faceId = (*fit)->getId();
+        if(faceId >= addedInUpdate.size()){
+            addedInUpdate.resize(faceId+1, 0);
         }
-        horizonOrdered.push_back(hm[he->getToVertex()]);
-        he= hm[he->getToVertex()];
+        addedInUpdate[faceId] = 1;
+        update.addedFaces.push_back(faceId);
     }
-    //Elimino il doppione
-    horizonOrdered.pop_back();
+}
 
-    return horizonOrdered;
+/**
+ * @brief ConvexHullCore::trackAllFaces()
+ * This method record all the faces of the dcel as added (used for the initial convex hull)
+ */
+void ConvexHullCore::trackAllFaces(Update& update){
+    std::vector<Dcel::Face*> faces;
+    for(Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit){
+        faces.push_back(*fit);
+    }
+    trackAddedFaces(faces, update);
+}
 
+/**
+ * @brief ConvexHullCore::finishUpdate()
+ * This method leave in the update only the added faces still in the dcel (without duplicates) and clean the
+ * marks for the next call of insertPoints()
+ */
+void ConvexHullCore::finishUpdate(Update& update){
+    int kept = 0;
+    for(unsigned int i=0; i<update.addedFaces.size(); i++){
+        unsigned int faceId = update.addedFaces[i];
+        if(addedInUpdate[faceId]){
+            addedInUpdate[faceId] = 0;
+            update.addedFaces[kept++] = faceId;
+        }
+    }
+    update.addedFaces.resize(kept);
 }
 
 /**
- * @brief ConvexHullCore::removeFacesVisibleByVertex(std::set<Dcel::Face *> *facesVisibleByVertex)
- * This method is executed to remove the face that the current point see
+ * @brief ConvexHullCore::getFacesVisibleFromFace()
+ * This method find all the faces visible by the point with a visit of the adjacent faces that starts from a
+ * visible face: the visible region is connected, so only the faces visible and the ones around them are tested
  */
-void ConvexHullCore::removeFacesVisibleByVertex(std::set<Dcel::Face *>* facesVisibleByVertex){
+void ConvexHullCore::getFacesVisibleFromFace(int point, Dcel::Face* face, OutsideSets& outsideSets, std::vector<Dcel::Face*>& facesVisibleByVertex){
+
+    //Le facce già controllate hanno il flag uguale all'epoca corrente (getHorizon() ne userà una nuova)
+    facesVisibleByVertex.clear();
+    ++visibleEpoch;
+    face -> setFlag(visibleEpoch);
+    facesVisibleByVertex.push_back(face);
+    for(unsigned int i=0; i<facesVisibleByVertex.size(); i++){
+        Dcel::HalfEdge* halfEdge = facesVisibleByVertex[i] -> getOuterHalfEdge();
+        for(int k=0; k<3; k++, halfEdge = halfEdge -> getNext()){
+            Dcel::Face* neighbour = halfEdge -> getTwin() -> getFace();
+            if(neighbour -> getFlag() != visibleEpoch){
+                neighbour -> setFlag(visibleEpoch);
+                if(outsideSets.isVisible(point, neighbour)){
+                    facesVisibleByVertex.push_back(neighbour);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullCore::getHorizon()
+ * This method is executed to find the horizon by a faces visible by a vertex.
+ * The visible faces are marked with the epoch of the current insertion, then the boundary of the visible
+ * region is walked through the twin and next pointers. The horizon (the half edges of the not visible faces
+ * that border the visible ones) is written already ordered in the buffer, and its vertices are marked too
+ */
+void ConvexHullCore::getHorizon(const std::vector<Dcel::Face *>& facesVisibleByVertex, std::vector<Dcel::HalfEdge*>& horizon){
+    CH_TRACE("getHorizon");
+
+    /* L'idea di questo metodo è di marcare le facce visibili dal punto con l'epoca dell'inserimento corrente (il flag della
+     * faccia), così l'appartenenza all'insieme delle facce visibili è un confronto. Si cerca un primo half edge di bordo:
+     * un half edge di una faccia visibile il cui twin (che fa parte dell'orizzonte) sta in una faccia non visibile.
+     * Il successivo half edge di bordo finisce nel fromVertex v del corrente: si ruota attorno a v passando per le facce
+     * visibili (prev, poi twin->prev), che sono già in cache, finchè il twin non è in una faccia non visibile.
+     * La regione visibile è un disco (i predicati sono esatti), quindi il giro si chiude sul primo half edge
+     */
+
+    horizon.clear();
+    ++visibleEpoch;
+
+    //Marco le facce visibili dal punto
+    for(std::vector<Dcel::Face*>::const_iterator fit = facesVisibleByVertex.begin(); fit != facesVisibleByVertex.end(); ++fit){
+        (*fit) -> setFlag(visibleEpoch);
+    }
+
+    //Cerco un primo half edge di bordo scorrendo gli half edge delle facce visibili
+    Dcel::HalfEdge* first = nullptr;
+    for(std::vector<Dcel::Face*>::const_iterator fit = facesVisibleByVertex.begin(); fit != facesVisibleByVertex.end() && first == nullptr; ++fit){
+        Dcel::HalfEdge* halfEdge = (*fit) -> getOuterHalfEdge();
+        for(int i=0; i<3; i++, halfEdge = halfEdge -> getNext()){
+            if(halfEdge -> getTwin() -> getFace() -> getFlag() != visibleEpoch){
+                first = halfEdge;
+                break;
+            }
+        }
+    }
+
+    //Percorro il bordo della regione visibile, l'orizzonte è formato dai twin degli half edge di bordo
+    Dcel::HalfEdge* current = first;
+    do{
+        horizon.push_back(current -> getTwin());
+        current -> getToVertex() -> setFlag(visibleEpoch);
+
+        Dcel::HalfEdge* previous = current -> getPrev();
+        while(previous -> getTwin() -> getFace() -> getFlag() == visibleEpoch){
+            previous = previous -> getTwin() -> getPrev();
+        }
+        current = previous;
+    }while(current != first);
+}
+
+/**
+ * @brief ConvexHullCore::removeFacesVisibleByVertex(const std::vector<Dcel::Face *>& facesVisibleByVertex)
+ * This method is executed to remove the face that the current point see. The faces and their half edges
+ * are not deleted from the dcel: they are unlinked and kept aside, so createNewFaces() can reuse them
+ * (with their ids) instead of allocating new elements; the ones not reused are deleted at the end of the step.
+ * The vertices not marked by getHorizon() are inside the visible region, so they are deleted
+ */
+void ConvexHullCore::removeFacesVisibleByVertex(const std::vector<Dcel::Face *>& facesVisibleByVertex){
+    CH_TRACE("removeFacesVisibleByVertex");
 
     //Conterrà i vertici da rimuovere
-    std::list<Dcel::Vertex*> vertexToRemove;
+    vertexToRemove.clear();
 
     //Scorro il set delle facce visibili dal vertice
-    for(std::set<Dcel::Face*>::iterator it = facesVisibleByVertex->begin(); it != facesVisibleByVertex->end(); ++it){
+    for(std::vector<Dcel::Face*>::const_iterator it = facesVisibleByVertex.begin(); it != facesVisibleByVertex.end(); ++it){
 
         Dcel::Face* face = *it;
 
-        //Scorro tutta la faccia
-        for(Dcel::Face::IncidentHalfEdgeIterator vit = face->incidentHalfEdgeBegin(); vit != face->incidentHalfEdgeEnd(); ++vit){
+        //Scorro tutta la faccia (è un triangolo)
+        Dcel::HalfEdge* he = face->getOuterHalfEdge();
+        for(int i=0; i<3; i++){
 
-             Dcel::HalfEdge* he = *vit;
+             Dcel::HalfEdge* next = he->getNext();
 
              //Prendo i vertici dell'half edge corrente
              Dcel::Vertex* fromVertex = he->getFromVertex();
              Dcel::Vertex* toVertex   = he->getToVertex();
 
-             //elimino l'half edge corrente dalla dcel
-             this->dcel->deleteHalfEdge(he);
+             //Scollego l'half edge corrente e lo tengo da parte per riusarlo, i twin dell'orizzonte verranno risettati
+             he -> setFromVertex(nullptr);
+             he -> setToVertex(nullptr);
+             he -> setTwin(nullptr);
+             he -> setNext(nullptr);
+             he -> setPrev(nullptr);
+             he -> setFace(nullptr);
+             recycledHalfEdges.push_back(he);
 
              //Decremento la cardinalità dei vertici in cui ho eliminato l'half edge
              fromVertex -> decrementCardinality();
              toVertex   -> decrementCardinality();
 
-             //quando i vertici hanno raggiunto la cardinalità 0, vuol dire che sono più necessari alla dcel e gli inserisco nella lista
-             if(fromVertex->getCardinality() == 0){
-                 vertexToRemove.push_front(fromVertex);
-             }
-             if(toVertex->getCardinality() == 0){
-                 vertexToRemove.push_front(toVertex);
+             //i vertici dell'orizzonte sono marcati con l'epoca corrente, quelli non marcati sono interni alla regione
+             //visibile e non sono più necessari alla dcel: gli marco a loro volta per inserirli una volta sola
+             if(fromVertex->getFlag() != visibleEpoch){
+                 fromVertex -> setFlag(visibleEpoch);
+                 vertexToRemove.push_back(fromVertex);
              }
+
+             he = next;
         }
 
-        //elimino la faccia dalla dcel
-        this -> dcel -> deleteFace(face);
+        //tengo da parte anche la faccia
+        face -> setOuterHalfEdge(nullptr);
+        recycledFaces.push_back(face);
     }
 
-    //elimino i vertici non necessari dalla dcel
-    for(std::list<Dcel::Vertex*>::iterator it = vertexToRemove.begin(); it != vertexToRemove.end(); ++it){
+    //elimino i vertici non necessari dalla dcel, il loro half edge incidente è tra quelli scollegati
+    for(std::vector<Dcel::Vertex*>::iterator it = vertexToRemove.begin(); it != vertexToRemove.end(); ++it){
+         (*it) -> setIncidentHalfEdge(nullptr);
          this -> dcel -> deleteVertex(*it);
     }
 }
 
 /**
- * @brief ConvexHullCore::createNewFaces(std::list<Dcel::HalfEdge *> horizon, Dcel::Vertex *)
- * This method is executed to create the new faces using the horizon
- * @return std::vector<Dcel::Face*> that contains the new faces create
+ * @brief ConvexHullCore::takeHalfEdge()
+ * This method return an half edge removed by removeFacesVisibleByVertex() if there is one, a new one otherwise
  */
-std::vector<Dcel::Face*> ConvexHullCore::createNewFaces(std::list<Dcel::HalfEdge *> horizon, Dcel::Vertex* v3){
+Dcel::HalfEdge* ConvexHullCore::takeHalfEdge(){
+
+    if(recycledHalfEdges.empty()){
+        return dcel -> addHalfEdge();
+    }
+    Dcel::HalfEdge* halfEdge = recycledHalfEdges.back();
+    recycledHalfEdges.pop_back();
+    return halfEdge;
+}
+
+/**
+ * @brief ConvexHullCore::takeFace()
+ * This method return a face removed by removeFacesVisibleByVertex() if there is one, a new one otherwise
+ */
+Dcel::Face* ConvexHullCore::takeFace(){
+
+    if(recycledFaces.empty()){
+        return dcel -> addFace();
+    }
+    Dcel::Face* face = recycledFaces.back();
+    recycledFaces.pop_back();
+    face -> setFlag(0);
+    return face;
+}
+
+/**
+ * @brief ConvexHullCore::releaseRecycledElements()
+ * This method delete from the dcel the faces and half edges removed but not reused by the new faces
+ * (there are more visible faces than new faces when some vertex of the hull is removed)
+ */
+void ConvexHullCore::releaseRecycledElements(){
+
+    for(std::vector<Dcel::HalfEdge*>::iterator it = recycledHalfEdges.begin(); it != recycledHalfEdges.end(); ++it){
+        this -> dcel -> deleteHalfEdge(*it);
+    }
+    for(std::vector<Dcel::Face*>::iterator it = recycledFaces.begin(); it != recycledFaces.end(); ++it){
+        this -> dcel -> deleteFace(*it);
+    }
+    recycledHalfEdges.clear();
+    recycledFaces.clear();
+}
+
+/**
+ * @brief ConvexHullCore::createNewFaces(const std::vector<Dcel::HalfEdge *>& horizon, Dcel::Vertex *, std::vector<Dcel::Face*>& newFaces)
+ * This method is executed to create the new faces using the horizon: the i-th new face, built on the i-th half edge
+ * of the horizon, is written in newFaces[i] (the vector is reused between the calls)
+ */
+void ConvexHullCore::createNewFaces(const std::vector<Dcel::HalfEdge *>& horizon, Dcel::Vertex* v3, std::vector<Dcel::Face*>& newFaces){
+    CH_TRACE("createNewFaces");
 
     /* L'idea di questo metodo è: si scorrono gli half edge dell'orizzonte ordinati, per ogni half edge di questi, si crea una nuova faccia e i suoi relativi half edge
      * in cui la direzione tra il nuovo half edge e quello dell'horizzonte è opposta.
      */
 
-    std::vector<Dcel::HalfEdge*> heEnter  = std::vector<Dcel::HalfEdge*>(horizon.size());
-    std::vector<Dcel::HalfEdge*> heExit   = std::vector<Dcel::HalfEdge*>(horizon.size());
-    std::vector<Dcel::Face*>     newFaces = std::vector<Dcel::Face*    >(horizon.size());
+    newFaces.resize(horizon.size());
 
 
     int i=0;
     //Scorro hli half edge dell'orizzonte per creare le nuove facce, ad ogni ciclo creo una faccia
-    for(std::list<Dcel::HalfEdge*>::iterator it = horizon.begin(); it != horizon.end(); ++it,i++){
+    for(std::vector<Dcel::HalfEdge*>::const_iterator it = horizon.begin(); it != horizon.end(); ++it,i++){
         Dcel::HalfEdge* currentHalfEdgeHorizon = *it;
 
-        //Creo i nuovi tre half edge della faccia corrente che sto creando
-        Dcel::HalfEdge* halfEdge1 = dcel -> addHalfEdge();
-        Dcel::HalfEdge* halfEdge2 = dcel -> addHalfEdge();
-        Dcel::HalfEdge* halfEdge3 = dcel -> addHalfEdge();
+        //Creo (o riuso) i nuovi tre half edge della faccia corrente che sto creando
+        Dcel::HalfEdge* halfEdge1 = takeHalfEdge();
+        Dcel::HalfEdge* halfEdge2 = takeHalfEdge();
+        Dcel::HalfEdge* halfEdge3 = takeHalfEdge();
 
-        //Creao la faccia e setto l'outer
-        Dcel::Face* currentFace = dcel->addFace();
+        //Creao (o riuso) la faccia e setto l'outer
+        Dcel::Face* currentFace = takeFace();
         currentFace ->setOuterHalfEdge(halfEdge1);
         newFaces[i] = currentFace;
 
@@ -354,9 +1358,6 @@ std::vector<Dcel::Face*> ConvexHullCore::createNewFaces(std::list<Dcel::HalfEdge
         v2 -> incrementCardinality();
         v3 -> incrementCardinality();
 
-        //Carico in un vettore gli halfedge uscenti dal vertice (che userò per settare i twin)
-        heExit[i] = halfEdge2;
-
         halfEdge3 -> setFromVertex(v3);
         halfEdge3 -> setToVertex(v1);
         halfEdge3 -> setFace(currentFace);
@@ -365,23 +1366,23 @@ std::vector<Dcel::Face*> ConvexHullCore::createNewFaces(std::list<Dcel::HalfEdge
         v3 -> setIncidentHalfEdge(halfEdge3);
         v3 -> incrementCardinality();
         v1 -> incrementCardinality();
-
-        //Carico in un vettore gli halfedge entranti del vertice (che usero per settare i twin)
-        heEnter[i] = halfEdge3;
     }
 
     //Settaggio twin half edge, usando il modulo per garantire che il cerchio si chiuda
     //i twin vengono settati secondo la proprietà
-    //che il twin dell'half edge uscente sia l'half edge del vettore dei vettori entranti,
-    //di una posizione in più rispetto alla sua, quindi, uscente[i]->setTwin(entrante[(i+(dim-1))%dim]) e viceversa;
+    //che il twin dell'half edge uscente dal vertice nella faccia i (il next dell'outer) sia l'half edge entrante
+    //nella faccia precedente (il prev dell'outer), quindi, uscente[i]->setTwin(entrante[(i+(dim-1))%dim]) e viceversa;
 
-    int dim=(heEnter.size());
+    int dim=(newFaces.size());
     for(int i=0; i < dim ; i++){
-        heEnter[(i+(dim-1))%dim] -> setTwin(heExit[i]);
-        heExit[i] -> setTwin(heEnter[(i+(dim-1))%dim]);
+        Dcel::HalfEdge* heExit  = newFaces[i] -> getOuterHalfEdge() -> getNext();
+        Dcel::HalfEdge* heEnter = newFaces[(i+(dim-1))%dim] -> getOuterHalfEdge() -> getPrev();
+        heEnter -> setTwin(heExit);
+        heExit -> setTwin(heEnter);
     }
 
-    return newFaces;
+    //Gli elementi rimossi e non riusati escono definitivamente dalla dcel
+    releaseRecycledElements();
 }
 
 /**
@@ -392,27 +1393,364 @@ std::vector<Dcel::Face*> ConvexHullCore::createNewFaces(std::list<Dcel::HalfEdge
 bool ConvexHullCore::isNormalFaceTurnedTowardsThePoint() const {
     //Questo metodo è di vitale importanza, se non eseguito crea bug che si notano una volta che vengono eliminate delle facce, ed è estremamente
     //difficile da rilevare.
-    Pointd p0 = vertexS[0] -> getCoordinate();
-    Pointd p1 = vertexS[1] -> getCoordinate();
-    Pointd p2 = vertexS[2] -> getCoordinate();
-    Pointd p3 = vertexS[3] -> getCoordinate();
-
-    Eigen::Matrix<double,4,4> matrix;
-    matrix<< p0.x(), p0.y(), p0.z(), 1,
-             p1.x(), p1.y(), p1.z(), 1,
-             p2.x(), p2.y(), p2.z(), 1,
-             p3.x(), p3.y(), p3.z(), 1;
-
-    //Calcolo il determinante della matrice
-    double det = matrix.determinant();
-
-    //se il det è <0 vuol dire che la normale della faccia punta verso il vertice 4, questo non va bene perchè cambierebbe il giro degli half edge nella faccia
-    if(det > std::numeric_limits<double>::epsilon() ){
-        return false;
-    }else{
-        return true;
+    Pointd p0 = getPoint(0);
+    Pointd p1 = getPoint(1);
+    Pointd p2 = getPoint(2);
+    Pointd p3 = getPoint(3);
+
+    //se il quarto punto sta dalla parte della normale (p1-p0)x(p2-p0) bisogna invertire il giro degli half edge nella faccia,
+    //i punti non sono coplanari quindi l'orientamento esatto non è mai nullo
+    CH_STATS(stats.orientationTests++);
+    return Predicates::orient3d(p0, p1, p2, p3) > 0.0;
+}
+
+/**
+ * @brief ConvexHullCore::setNumberThreads()
+ * This method set the number of threads used to build and update the conflict graph: 1 (the default) means
+ * serial execution, 0 one thread for every core. The convex hull is the same for any number of threads
+ */
+void ConvexHullCore::setNumberThreads(int numberThreads){
+    //Il thread pool viene ricreato solo se il numero di thread cambia
+    if(numberThreads != this->numberThreads){
+        threadPool.reset();
+    }
+    this -> numberThreads = numberThreads;
+}
+
+/**
+ * @brief ConvexHullCore::getThreadPool()
+ * This method return the thread pool shared by the slabs of keepSubHullsVertexs() and by the conflict graph,
+ * created at the first use and kept by the next executions of findConvexHull()
+ */
+ThreadPool* ConvexHullCore::getThreadPool(){
+    if(threadPool == nullptr){
+        threadPool.reset(new ThreadPool(numberThreads));
     }
+    return threadPool.get();
+}
+
+/**
+ * @brief ConvexHullCore::getNumberThreads()
+ * This method return the number of threads actually used, resolving 0 to the number of cores of the machine
+ */
+int ConvexHullCore::getNumberThreads() const{
+    return numberThreads > 0 ? numberThreads : std::max(1, (int) std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief ConvexHullCore::setPoints(const Pointd *points, int numberPoints)
+ * This method change the input points of the next findConvexHull() (a contiguous array of numberPoints points),
+ * so the same object, with its buffers, can compute the convex hull of many sets of points
+ */
+void ConvexHullCore::setPoints(const Pointd* points, int numberPoints){
+    this -> points       = points;
+    this -> span         = PointSpan();
+    this -> numberVertex = numberPoints;
+}
+
+/**
+ * @brief ConvexHullCore::setPoints(const PointSpan &span)
+ * This method change the input points of the next findConvexHull() to the ones of an array of coordinates
+ */
+void ConvexHullCore::setPoints(const PointSpan& span){
+    this -> points       = nullptr;
+    this -> span         = span;
+    this -> numberVertex = span.numberPoints;
+}
 
+/**
+ * @brief ConvexHullCore::setStrategy()
+ * This method select the algorithm used by findConvexHull() (INCREMENTAL is the default)
+ */
+void ConvexHullCore::setStrategy(Strategy strategy){
+    this -> strategy = strategy;
+}
+
+/**
+ * @brief ConvexHullCore::setInteriorCulling()
+ * This method enable (or disable, the default) the removal of the points strictly inside the polytope of the
+ * extreme points before the permutation (see cullInteriorVertexs()). The convex hull does not change
+ */
+void ConvexHullCore::setInteriorCulling(bool interiorCulling){
+    this -> interiorCulling = interiorCulling;
+}
+
+/**
+ * @brief ConvexHullCore::setInsertionOrder()
+ * This method set the order in which the next executions of findConvexHull() insert the points (see InsertionOrder,
+ * the default is RANDOM_ORDER). The convex hull does not change
+ */
+void ConvexHullCore::setInsertionOrder(InsertionOrder insertionOrder){
+    this -> insertionOrder = insertionOrder;
+}
+
+/**
+ * @brief ConvexHullCore::setRandomSeed()
+ * This method set the seed of the random insertion order (the default is DEFAULT_RANDOM_SEED)
+ */
+void ConvexHullCore::setRandomSeed(unsigned int randomSeed){
+    this -> randomSeed = randomSeed;
+}
+
+/**
+ * @brief ConvexHullCore::setStepCallback()
+ * This method set the callback called after every inserted point, replacing the one passed to the constructor
+ */
+void ConvexHullCore::setStepCallback(StepCallback onStep){
+    this -> onStep = onStep;
+}
+
+/**
+ * @brief ConvexHullCore::setProgressCallback()
+ * This method set the callback called during the insertion of the points with the fraction (from 0 to 1) of the
+ * work done. It is called by the thread that executes findConvexHull()
+ */
+void ConvexHullCore::setProgressCallback(ProgressCallback onProgress){
+    this -> onProgress = onProgress;
+}
+
+/**
+ * @brief ConvexHullCore::setCancelFlag()
+ * This method set the flag that interrupts findConvexHull() when it becomes true (for example set by another
+ * thread). If the flag is set during the insertion of the points the dcel contains the convex hull of the points
+ * inserted so far, otherwise it is empty. The flag must stay valid until the end of findConvexHull()
+ */
+void ConvexHullCore::setCancelFlag(const std::atomic<bool>* cancelFlag){
+    this -> cancelFlag = cancelFlag;
+}
+
+/**
+ * @brief ConvexHullCore::setInsertionLog()
+ * This method set the log where the next executions record the construction of the convex hull: the initial convex
+ * hull and, for every inserted point, the removed faces and the horizon (see ConvexHullLog and ConvexHullPlayer).
+ * A null log disables the record
+ */
+void ConvexHullCore::setInsertionLog(ConvexHullLog* insertionLog){
+    this -> insertionLog = insertionLog;
+}
+
+/**
+ * @brief ConvexHullCore::setMeshDeltaTracking()
+ * This method enable or disable the record of the faces removed and added by the next executions of
+ * findConvexHull(), taken with takeMeshDelta(). The record starts from an empty convex hull: the initial one is
+ * recorded as added
+ */
+void ConvexHullCore::setMeshDeltaTracking(bool meshDeltaTracking){
+    this -> trackedUpdate = meshDeltaTracking ? &meshDeltaUpdate : nullptr;
+}
+
+/**
+ * @brief ConvexHullCore::takeMeshDelta()
+ * This method write in the delta the faces removed and added since the previous call (or since the start of
+ * findConvexHull()): the faces added and then removed in the meantime are not reported. It can be called by the
+ * step callback, the cost is proportional to the faces changed and not to the size of the convex hull
+ */
+void ConvexHullCore::takeMeshDelta(MeshDelta& delta){
+
+    delta.removedFaces.clear();
+    delta.addedFaces.clear();
+    delta.addedTriangles.clear();
+    if(trackedUpdate == nullptr){
+        return;
+    }
+
+    finishUpdate(*trackedUpdate);
+    delta.removedFaces.swap(trackedUpdate->removedFaces);
+    delta.addedFaces.swap(trackedUpdate->addedFaces);
+    trackedUpdate->removedFaces.clear();
+    trackedUpdate->addedFaces.clear();
+
+    delta.addedTriangles.reserve(9 * delta.addedFaces.size());
+    for(unsigned int i=0; i<delta.addedFaces.size(); i++){
+        const Dcel::HalfEdge* halfEdge = dcel->getFace(delta.addedFaces[i])->getOuterHalfEdge();
+        for(int k=0; k<3; k++, halfEdge = halfEdge->getNext()){
+            Pointd p = halfEdge->getFromVertex()->getCoordinate();
+            delta.addedTriangles.push_back(p.x());
+            delta.addedTriangles.push_back(p.y());
+            delta.addedTriangles.push_back(p.z());
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullCore::isCancelled()
+ * This method return true if the interruption of the execution was requested with the cancel flag
+ */
+bool ConvexHullCore::isCancelled() const{
+    return cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief ConvexHullCore::setPhaseCallback()
+ * This method set the callback called at the end of every phase of findConvexHull()
+ * ("getVertexs", "culling", "subHulls", "degenerateHull", "executePermutation", "setTetrahedron", "initializeCG" or
+ * "initializeOutsideSets", "insertion")
+ */
+void ConvexHullCore::setPhaseCallback(PhaseCallback onPhase){
+    this -> onPhase = onPhase;
+}
+
+/**
+ * @brief ConvexHullCore::getStats()
+ * This method return the statistics of the last execution of findConvexHull()
+ * (all zero if the project is not compiled with CONVEXHULL_STATS)
+ */
+const ConvexHullStats& ConvexHullCore::getStats() const{
+    return stats;
+}
+
+/**
+ * @brief ConvexHullCore::getMesh()
+ * This method write the convex hull in the dcel as contiguous arrays with dense indexs (see Mesh), in one pass on
+ * the vertices and one on the faces: the holes of the ids of the dcel do not appear in the indexs. The planes and
+ * the adjacency are computed only if requested with options (MESH_PLANES, MESH_ADJACENCY)
+ */
+void ConvexHullCore::getMesh(Mesh& mesh, int options) const{
+
+    const Dcel* hull = this -> dcel;
+    mesh.vertices.clear();
+    mesh.triangles.clear();
+    mesh.planes.clear();
+    mesh.adjacency.clear();
+    mesh.vertices.reserve(3 * hull->getNumberVertices());
+    mesh.triangles.reserve(3 * hull->getNumberFaces());
+
+    //Gli indici sono assegnati nell'ordine della dcel
+    int numberVertices = 0;
+    for(Dcel::ConstVertexIterator vit = hull->vertexBegin(); vit != hull->vertexEnd(); ++vit){
+        unsigned int id = (*vit)->getId();
+        if(id >= meshVertexIndex.size()){
+            meshVertexIndex.resize(id + 1);
+        }
+        meshVertexIndex[id] = numberVertices++;
+        Pointd p = (*vit)->getCoordinate();
+        mesh.vertices.push_back(p.x());
+        mesh.vertices.push_back(p.y());
+        mesh.vertices.push_back(p.z());
+    }
+
+    int numberTriangles = 0;
+    for(Dcel::ConstFaceIterator fit = hull->faceBegin(); fit != hull->faceEnd(); ++fit){
+        unsigned int id = (*fit)->getId();
+        if(id >= meshFaceIndex.size()){
+            meshFaceIndex.resize(id + 1);
+        }
+        meshFaceIndex[id] = numberTriangles++;
+        const Dcel::HalfEdge* halfEdge = (*fit)->getOuterHalfEdge();
+        for(int k=0; k<3; k++, halfEdge = halfEdge->getNext()){
+            mesh.triangles.push_back(meshVertexIndex[halfEdge->getFromVertex()->getId()]);
+        }
+    }
+
+    if(options & MESH_PLANES){
+        computeMeshPlanes(mesh);
+    }
+
+    //Il triangolo adiacente è la faccia del twin di ogni half edge, con l'indice denso assegnato sopra
+    if(options & MESH_ADJACENCY){
+        mesh.adjacency.reserve(3 * numberTriangles);
+        for(Dcel::ConstFaceIterator fit = hull->faceBegin(); fit != hull->faceEnd(); ++fit){
+            const Dcel::HalfEdge* halfEdge = (*fit)->getOuterHalfEdge();
+            for(int k=0; k<3; k++, halfEdge = halfEdge->getNext()){
+                const Dcel::HalfEdge* twin = halfEdge->getTwin();
+                mesh.adjacency.push_back(twin != nullptr && twin->getFace() != nullptr ? meshFaceIndex[twin->getFace()->getId()] : -1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullCore::computeMeshPlanes()
+ * This method compute the plane of every triangle of the mesh, with the outward normal normalized (right hand rule
+ * on the vertices of the triangle)
+ */
+void ConvexHullCore::computeMeshPlanes(Mesh& mesh){
+
+    int numberTriangles = mesh.getNumberTriangles();
+    mesh.planes.clear();
+    mesh.planes.reserve(4 * numberTriangles);
+    for(int t=0; t<numberTriangles; t++){
+        const double* p0 = &mesh.vertices[3*mesh.triangles[3*t]];
+        const double* p1 = &mesh.vertices[3*mesh.triangles[3*t+1]];
+        const double* p2 = &mesh.vertices[3*mesh.triangles[3*t+2]];
+        Pointd normal = Pointd(p1[0]-p0[0], p1[1]-p0[1], p1[2]-p0[2]).cross(Pointd(p2[0]-p0[0], p2[1]-p0[1], p2[2]-p0[2]));
+        double length = normal.getLength();
+        if(length > 0.0){
+            normal = normal / length;
+        }
+        mesh.planes.push_back(normal.x());
+        mesh.planes.push_back(normal.y());
+        mesh.planes.push_back(normal.z());
+        mesh.planes.push_back(-(normal.x()*p0[0] + normal.y()*p0[1] + normal.z()*p0[2]));
+    }
+}
+
+/**
+ * @brief ConvexHullCore::meshToDcel()
+ * This method replace the content of the dcel with the triangles of the mesh. The mesh must have the adjacency
+ * (MESH_ADJACENCY): the twin of every half edge is found in the adjacent triangle
+ */
+void ConvexHullCore::meshToDcel(const Mesh& mesh, Dcel& dcel){
+
+    dcel.reset();
+
+    int numberVertices = mesh.getNumberVertices();
+    std::vector<Dcel::Vertex*> vertexs(numberVertices);
+    for(int i=0; i<numberVertices; i++){
+        vertexs[i] = dcel.addVertex(Pointd(mesh.vertices[3*i], mesh.vertices[3*i+1], mesh.vertices[3*i+2]));
+    }
+
+    //L'half edge k del triangolo t va dal vertice k al vertice k+1, come nella mesh
+    int numberTriangles = mesh.getNumberTriangles();
+    std::vector<Dcel::HalfEdge*> halfEdges(3 * numberTriangles);
+    for(int t=0; t<numberTriangles; t++){
+        Dcel::Face* face = dcel.addFace();
+        for(int k=0; k<3; k++){
+            halfEdges[3*t+k] = dcel.addHalfEdge();
+        }
+        face -> setOuterHalfEdge(halfEdges[3*t]);
+        for(int k=0; k<3; k++){
+            Dcel::HalfEdge* halfEdge = halfEdges[3*t+k];
+            Dcel::Vertex* from = vertexs[mesh.triangles[3*t+k]];
+            Dcel::Vertex* to   = vertexs[mesh.triangles[3*t+(k+1)%3]];
+            halfEdge -> setFromVertex(from);
+            halfEdge -> setToVertex(to);
+            halfEdge -> setFace(face);
+            halfEdge -> setNext(halfEdges[3*t+(k+1)%3]);
+            halfEdge -> setPrev(halfEdges[3*t+(k+2)%3]);
+            from -> setIncidentHalfEdge(halfEdge);
+            from -> incrementCardinality();
+            to   -> incrementCardinality();
+        }
+    }
+
+    //Il twin è l'half edge del triangolo adiacente che percorre lo stesso lato al contrario
+    for(int t=0; t<numberTriangles; t++){
+        for(int k=0; k<3; k++){
+            int adjacent = mesh.adjacency[3*t+k];
+            if(adjacent < 0){
+                continue;
+            }
+            int to = mesh.triangles[3*t+(k+1)%3];
+            for(int j=0; j<3; j++){
+                if(mesh.triangles[3*adjacent+j] == to){
+                    halfEdges[3*t+k] -> setTwin(halfEdges[3*adjacent+j]);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullCore::findConvexHull(Mesh &mesh, int options)
+ * This method find the convex hull, as findConvexHull(), and write it in the mesh (see getMesh()). The algorithm
+ * works on the dcel, so the convex hull is still built in the dcel and then walked by getMesh(): the method only
+ * saves the caller the export. The next execution resets the dcel, deleting its elements
+ */
+void ConvexHullCore::findConvexHull(Mesh& mesh, int options){
+    findConvexHull();
+    getMesh(mesh, options);
 }
 
 /**
@@ -421,76 +1759,164 @@ bool ConvexHullCore::isNormalFaceTurnedTowardsThePoint() const {
  * This method, is the principal method of the class
  */
 void ConvexHullCore::findConvexHull(){
+    CH_TRACE("findConvexHull");
+
+    //Le statistiche si riferiscono sempre all'ultima esecuzione, il convex hull online non viene più aggiornato
+    CH_STATS(stats.reset());
+    onlineOutsideSets.reset();
+    pendingPoints.clear();
+    if(trackedUpdate){
+        trackedUpdate->addedFaces.clear();
+        trackedUpdate->removedFaces.clear();
+        std::fill(addedInUpdate.begin(), addedInUpdate.end(), 0);
+    }
 
-    //Salva i vertici della dcel in un vector (vertexS) perchè alla dcel verra chiamato reset()
+    //Indici dei punti in ingresso (vertexS); le coordinate della dcel vengono copiate perchè alla dcel verra chiamato reset()
     getVertexs();
+    if(onPhase) onPhase("getVertexs");
+    if(onProgress) onProgress(0.0);
+
+    //Scarta i punti certamente interni al polytope dei punti estremi, prima che entrino nel conflict graph
+    if(interiorCulling){
+        cullInteriorVertexs();
+        if(onPhase) onPhase("culling");
+    }
+
+    //Con la strategia divide et impera restano solo i vertici dei convex hull delle fette
+    if(strategy == PARALLEL_DIVIDE_AND_CONQUER){
+        keepSubHullsVertexs();
+        if(onPhase) onPhase("subHulls");
+    }
 
-    //Calcola una permutazione random degli n punti
+    //Interruzione richiesta durante le fasi preliminari: la dcel resta vuota
+    if(isCancelled()){
+        this -> dcel -> reset();
+        if(insertionLog) insertionLog->clear();
+        releaseVertexs();
+        return;
+    }
+
+    //Sceglie i 4 vertici del tetraedro iniziale tra i punti estremi; se i punti sono tutti uguali, allineati o
+    //complanari il convex hull non è un poliedro e viene costruito direttamente
+    int dimension = selectInitialSimplex();
+    if(dimension < 3){
+        this -> dcel -> reset();
+        setDegenerateHull(dimension);
+        if(insertionLog) insertionLog->setInitialHull(*dcel);
+        if(trackedUpdate) trackAllFaces(*trackedUpdate);
+        if(onPhase) onPhase("degenerateHull");
+        if(onProgress) onProgress(1.0);
+        releaseVertexs();
+        return;
+    }
+
+    //Calcola una permutazione random dei punti dopo i primi 4
     executePermutation();
+    if(onPhase) onPhase("executePermutation");
 
     //Pulizia della dcel, che conterrà il convex hull alla fine dell'algoritmo
     this -> dcel -> reset();
+    this -> visibleEpoch = 0;
 
     //Trova 4 punti che formano il tetraedro (quindi il convex hull di questi 4 punti)
     setTetrahedron();
+    if(insertionLog) insertionLog->setInitialHull(*dcel);
+    if(trackedUpdate) trackAllFaces(*trackedUpdate);
+    if(onPhase) onPhase("setTetrahedron");
+
+    //Con il Quickhull i punti vengono inseriti in ordine di distanza, senza conflict graph
+    if(strategy == QUICKHULL){
+        insertFarthestPoints();
+        if(onProgress && !isCancelled()) onProgress(1.0);
+        releaseVertexs();
+        return;
+    }
 
     //Inizializza il conflict graph con tutte le coppie visibili (Pt,f) con f faccia in dcel e t>4 (quindi con i punti successivi)
-    ConflictGraph conflictGraph = ConflictGraph(this->dcel, this-> vertexS, this-> numberVertex);
+    //Le coordinate vengono copiate nel buffer SoA nell'ordine della permutazione, per i kernel del conflict graph
+    assignPointBuffer();
+    ConflictGraph conflictGraph = ConflictGraph(this->dcel, this-> pointBuffer, &this->stats);
+    if(numberThreads != 1){
+        conflictGraph.setThreadPool(getThreadPool());
+    }
     conflictGraph.initializeCG();
+    if(onPhase) onPhase("initializeCG");
+
+    //Buffer riusati ad ogni passo, evitano di allocare nuovi contenitori per ogni punto
+    std::vector<Dcel::Face*> facesVisibleByVertex;
+    std::vector<int> vertexToControl;
+    std::vector<int> offsets;
+    std::vector<Dcel::HalfEdge*> horizon;
+    std::vector<Dcel::Face*> newFaces;
 
     //Ciclo principlae sei punti, dal punto 4 fino alla fine
-    for(int point_i=4; point_i < numberVertex; point_i++){
+    const int PROGRESS_INTERVAL = 1024;
+    int numberPoints = vertexS.size();
+    for(int point_i=4; point_i < numberPoints && !isCancelled(); point_i++){
 
-        Dcel::Vertex* currentPoint = vertexS[point_i];
+        if(onProgress && point_i % PROGRESS_INTERVAL == 0){
+            onProgress((double) point_i / numberPoints);
+        }
 
-        //Prendo le facce visibili dal vertice
-        std::set<Dcel::Face*>* facesVisibleByVertex = conflictGraph.getFacesVisibleByVertex(currentPoint);
-        std::list<Dcel::HalfEdge*> horizon;
+        //Prendo le facce visibili dal vertice (copiate, perchè la vista viene invalidata dalla cancellazione delle facce)
+        ConflictGraph::FacesView visibleView = conflictGraph.getFacesVisibleByVertex(point_i);
 
 
         //Se il punto corrente non è all'interno del convex hull, allora bisogna aggiornare il convexhull
-        if(facesVisibleByVertex->size()>0){
+        if(!visibleView.empty()){
+            CH_TRACE("insertPoint");
+
+            facesVisibleByVertex.assign(visibleView.begin(), visibleView.end());
+
+            //Eliminazione del punto dal conflict graph: sta sul piano di tutte le nuove facce, quindi non deve
+            //comparire tra i candidati (il predicato esatto lo scarterebbe comunque, ma con un test esatto per ogni faccia)
+            conflictGraph.deleteVertex(point_i);
 
             //Inserimento punto nella dcel
-            Dcel::Vertex* currentVertex = dcel->addVertex(vertexS[point_i]->getCoordinate());
+            Dcel::Vertex* currentVertex = dcel->addVertex(getPoint(point_i));
 
 
             //Ricerca Orizzonte
-            horizon = getHorizon(facesVisibleByVertex);
-            std::map<Dcel::HalfEdge *, std::set<Dcel::Vertex*>*> vertexMapForUpdateCG = conflictGraph.getVertexMapToControlForTheNewFace(horizon);
+            getHorizon(facesVisibleByVertex, horizon);
+            CH_STATS(stats.insertedPoints++);
+            CH_STATS(ConvexHullStats::addToHistogram(stats.visibleFacesHistogram, facesVisibleByVertex.size()));
+            CH_STATS(ConvexHullStats::addToHistogram(stats.horizonHistogram, horizon.size()));
+            conflictGraph.getVertexToControlForTheNewFaces(horizon, vertexToControl, offsets);
 
 
             //Cancellazione Facce Visibili dal punto
+            if(insertionLog) insertionLog->beginStep(getInputIndex(point_i), facesVisibleByVertex);
+            if(trackedUpdate) trackRemovedFaces(facesVisibleByVertex, *trackedUpdate);
             conflictGraph.deleteFaces( facesVisibleByVertex);
             removeFacesVisibleByVertex(facesVisibleByVertex);
 
 
             //Creazione nuove facce
-            std::vector<Dcel::Face*> newFaces = createNewFaces(horizon,currentVertex);
+            createNewFaces(horizon, currentVertex, newFaces);
+            if(insertionLog) insertionLog->endStep(currentVertex, horizon, newFaces);
+            if(trackedUpdate) trackAddedFaces(newFaces, *trackedUpdate);
 
-            //Aggiornamento CG con le nuove facce inserite
-            std::list<Dcel::HalfEdge*>::iterator hit = horizon.begin();
-            for(unsigned int i=0; i< newFaces.size();i++,++hit){
-                Dcel::HalfEdge* currentHalfEdge = *hit;
-
-                std::set<Dcel::Vertex*>* setVertex = vertexMapForUpdateCG[currentHalfEdge];
-                conflictGraph.updateCG(newFaces[i], setVertex);
-            }
+            //Aggiornamento CG con le nuove facce inserite, i candidati della faccia i sono quelli dell'i-esimo half edge dell'orizzonte
+            conflictGraph.updateCG(newFaces, vertexToControl, offsets);
 
             //Se l'utente vuole vedere come viene costruito il CH passo per passo, aggiorno il canvas. Questo If l'ho messo
             //dentro l'if principale dell'algoritmo per evitare di aggiornare il canvas inutilmente
-            if(isClicked){
+            if(onStep){
                 //Eccolooo..
-                this -> dcel       -> update();
-                this -> mainWindow -> updateGlCanvas();
+                onStep();
             }
 
 
+        }else{
+            //Il punto è interno al convex hull corrente e viene scartato
+            CH_STATS(stats.interiorPoints++);
         }
-        //Eliminazione del punto dal conflict graph
-        conflictGraph.deleteVertex(currentPoint);
 
     }
+    if(onPhase) onPhase("insertion");
+    if(onProgress && !isCancelled()) onProgress(1.0);
+
+    releaseVertexs();
 }
 
 /*********************************************************************
@@ -2,44 +2,220 @@
 #define CONVEXHULLCORE_H
 
 
-#include "GUI/managers/convexhullmanager.h"
-#include "ui_convexhullmanager.h"
-#include <QFrame>
-#include <iomanip>
-#include "lib/dcel/drawable_dcel.h"
-#include "GUI/mainwindow.h"
-#include "common.h"
-#include "GUI/managers/dcelmanager.h"
-#include "lib/common/timer.h"
+#include "lib/dcel/dcel.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
 #include <math.h>
 #include <GUI/ConvexHullCore/conflictgraph.h>
+#include <GUI/ConvexHullCore/convexhulllog.h>
+#include <GUI/ConvexHullCore/convexhullstats.h>
+#include <GUI/ConvexHullCore/convexhulltrace.h>
+#include <GUI/ConvexHullCore/outsidesets.h>
+#include <GUI/ConvexHullCore/pointspan.h>
+#include <GUI/ConvexHullCore/predicates.h>
+#include <GUI/ConvexHullCore/threadpool.h>
+#include <GUI/ConvexHullCore/visibilitykernels.h>
 
 
 class ConvexHullCore{
 public:
+    //Richiamata dopo ogni punto inserito nel convex hull (la GUI la usa per mostrare le fasi)
+    typedef std::function<void()> StepCallback;
+    //Richiamata alla fine di ogni fase dell'algoritmo con il suo nome (usata dai benchmark)
+    typedef std::function<void(const char* phase)> PhaseCallback;
+    //Richiamata durante l'inserimento dei punti con la frazione (tra 0 e 1) del lavoro svolto
+    typedef std::function<void(double progress)> ProgressCallback;
+
+    //INCREMENTAL: l'algoritmo incrementale randomizzato su tutti i punti.
+    //PARALLEL_DIVIDE_AND_CONQUER: i punti vengono divisi in fette lungo l'asse più lungo, il convex hull di ogni fetta
+    //viene calcolato in parallelo e l'algoritmo incrementale gira solo sull'unione dei vertici dei convex hull delle fette.
+    //QUICKHULL: ogni punto esterno è assegnato ad una faccia che vede e viene inserito sempre il punto più lontano
+    enum Strategy { INCREMENTAL, PARALLEL_DIVIDE_AND_CONQUER, QUICKHULL };
+
+    //Ordine di inserimento dei punti dopo il tetraedro iniziale, generato dal seme (vedi setRandomSeed()).
+    //RANDOM_ORDER: permutazione uniforme.
+    //BRIO_ORDER: biased randomized insertion order, i punti vengono divisi in round casuali (ogni round contiene circa
+    //metà dei punti del successivo) inseriti in ordine e ogni round è ordinato lungo la curva di Morton, così punti
+    //inseriti di seguito toccano facce e conflitti vicini. La complessità attesa resta quella dell'ordine casuale
+    enum InsertionOrder { RANDOM_ORDER, BRIO_ORDER };
+
+    //Dimensione minima del primo round di BRIO_ORDER: i round più piccoli vengono uniti al primo
+    static const int BRIO_MIN_ROUND = 64;
+    static const unsigned int DEFAULT_RANDOM_SEED = 5489u;
+
+    //Facce cambiate da una chiamata di insertPoints(), con i loro id nella dcel: le facce rimosse esistevano prima
+    //della chiamata, quelle aggiunte esistono dopo (un id riusato può comparire in entrambe le liste)
+    struct Update{
+        std::vector<unsigned int> addedFaces;
+        std::vector<unsigned int> removedFaces;
+    };
+
+    //Convex hull in array contigui con indici densi: le coordinate x y z dei vertici e, per ogni triangolo, i 3 indici
+    //dei vertici in senso antiorario visto da fuori. A richiesta (MeshOptions) per ogni triangolo anche il piano
+    //(normale unitaria uscente a, b, c e offset d) e l'adiacenza: adjacency[3*t+k] è il triangolo dall'altra parte del
+    //lato che va dal vertice k al vertice k+1 del triangolo t (-1 se non esiste)
+    struct Mesh{
+        std::vector<double> vertices;
+        std::vector<int>    triangles;
+        std::vector<double> planes;
+        std::vector<int>    adjacency;
+        int getNumberVertices() const { return vertices.size() / 3; }
+        int getNumberTriangles() const { return triangles.size() / 3; }
+    };
+    enum MeshOptions { MESH_PLANES = 1, MESH_ADJACENCY = 2 };
+
+    //Modifiche del convex hull tra due chiamate di takeMeshDelta(): gli id nella dcel delle facce rimosse e di quelle
+    //aggiunte, con le coordinate x y z dei 3 vertici di ogni faccia aggiunta (9 valori per faccia). Le facce rimosse
+    //vanno tolte prima di inserire quelle aggiunte, perchè un id riusato può comparire in entrambe le liste
+    struct MeshDelta{
+        std::vector<unsigned int> removedFaces;
+        std::vector<unsigned int> addedFaces;
+        std::vector<double>       addedTriangles;
+    };
+
     //method
-    ConvexHullCore(DrawableDcel *dcel,MainWindow* mainWindow, bool isClicked);
+    ConvexHullCore(Dcel *dcel, StepCallback onStep = StepCallback());
+    ConvexHullCore(const Pointd* points, int numberPoints, Dcel *dcel, StepCallback onStep = StepCallback());
+    ConvexHullCore(const PointSpan& span, Dcel *dcel, StepCallback onStep = StepCallback());
+    void setPoints(const Pointd* points, int numberPoints);
+    void setPoints(const PointSpan& span);
     void findConvexHull();
+    void findConvexHull(Mesh& mesh, int options = 0);
+    void getMesh(Mesh& mesh, int options = 0) const;
+    static void computeMeshPlanes(Mesh& mesh);
+    static void meshToDcel(const Mesh& mesh, Dcel& dcel);
+    void insertPoints(const Pointd* points, int numberPoints, Update* update = nullptr);
+    void setStepCallback(StepCallback onStep);
+    void setPhaseCallback(PhaseCallback onPhase);
+    void setProgressCallback(ProgressCallback onProgress);
+    void setCancelFlag(const std::atomic<bool>* cancelFlag);
+    void setInsertionLog(ConvexHullLog* insertionLog);
+    void setMeshDeltaTracking(bool meshDeltaTracking);
+    void takeMeshDelta(MeshDelta& delta);
+    void setNumberThreads(int numberThreads);
+    void setStrategy(Strategy strategy);
+    void setInteriorCulling(bool interiorCulling);
+    void setInsertionOrder(InsertionOrder insertionOrder);
+    void setRandomSeed(unsigned int randomSeed);
+    const ConvexHullStats& getStats() const;
+    static bool getExtremePolytope(const PointBuffer& points, double maxAbsCoordinate, std::vector<FacePlane>& interiorPlanes);
+    static int findInteriorPoints(const std::vector<FacePlane>& interiorPlanes, const PointBuffer& points,
+                                  std::vector<int>& interior, std::vector<int>& buffer, unsigned long long& tests);
     
 private:
     //method
     bool verifyEuleroProperty() const;
     void getVertexs();
+    void releaseVertexs();
+    bool isCancelled() const;
+    int getNumberThreads() const;
+    ThreadPool* getThreadPool();
+    Pointd getPoint(int i) const;
+    Pointd getInputPoint(int index) const;
+    int getInputIndex(int i) const;
+    void assignPointBuffer();
+    void cullInteriorVertexs();
+    void keepSubHullsVertexs();
+    void setSlab(const Pointd* points, const PointSpan& span, const int* slabIndexs, int numberPoints);
+    template <class PointAccessor>
+    static bool isFullDimensional(int numberPoints, const PointAccessor& getPoint);
+    static bool areCollinear(const Pointd& p0, const Pointd& p1, const Pointd& p2);
+    void moveToFront(int* indexs, int number);
+    int selectInitialSimplex();
     void executePermutation();
-    bool areCoplanar() const;
+    void executeBiasedPermutation(std::mt19937& random);
+    static unsigned long long getMortonCode(const Pointd& point, const Pointd& min, const Pointd& scale);
+    void setDegenerateHull(int dimension);
+    void setPolygon();
     void setTetrahedron();
-    std::list<Dcel::HalfEdge*> getHorizon(std::set<Dcel::Face*>* facesVisibleByVertex) const;
-    void removeFacesVisibleByVertex(std::set<Dcel::Face*>* facesVisibleByVertex);
-    std::vector<Dcel::Face*> createNewFaces(std::list<Dcel::HalfEdge*> horizon, Dcel::Vertex*);
+    void insertFarthestPoints();
+    void expandFarthestPoints(OutsideSets& outsideSets, Update* update);
+    void buildOnlineHull(const Pointd* points, int numberPoints, Update* update);
+    void trackRemovedFaces(const std::vector<Dcel::Face*>& faces, Update& update);
+    void trackAddedFaces(const std::vector<Dcel::Face*>& faces, Update& update);
+    void trackAllFaces(Update& update);
+    void finishUpdate(Update& update);
+    void getFacesVisibleFromFace(int point, Dcel::Face* face, OutsideSets& outsideSets, std::vector<Dcel::Face*>& facesVisibleByVertex);
+    void getHorizon(const std::vector<Dcel::Face*>& facesVisibleByVertex, std::vector<Dcel::HalfEdge*>& horizon);
+    void removeFacesVisibleByVertex(const std::vector<Dcel::Face*>& facesVisibleByVertex);
+    void createNewFaces(const std::vector<Dcel::HalfEdge*>& horizon, Dcel::Vertex*, std::vector<Dcel::Face*>& newFaces);
+    Dcel::HalfEdge* takeHalfEdge();
+    Dcel::Face* takeFace();
+    void releaseRecycledElements();
     bool isNormalFaceTurnedTowardsThePoint() const;
 
     //variable
-    DrawableDcel* dcel;
-    MainWindow* mainWindow;
+    Dcel* dcel;
+    const Pointd* points;
+    //Punti in ingresso letti da un array di coordinate (usato se points è nullo e lo span non è vuoto)
+    PointSpan span;
     int numberVertex;
-    std::vector<Dcel::Vertex*> vertexS;
-    const bool isClicked;
+    //Punti dell'esecuzione corrente: l'array o lo span passati (solo referenziati), le coordinate copiate dalla dcel
+    //o i vertici dei convex hull delle fette. vertexS contiene i loro indici, nell'ordine in cui vengono elaborati
+    const Pointd* inputPoints;
+    PointSpan inputSpan;
+    //Se non è nullo (una fetta di keepSubHullsVertexs()) gli indici, nell'array o nello span, dei punti in ingresso
+    const int* slabIndexs;
+    std::vector<double> inputCoordinates;
+    std::vector<Pointd> subHullPoints;
+    std::vector<int> vertexS;
+    PointBuffer pointBuffer;
+    //Facce e half edge delle facce visibili rimosse, ancora presenti nella dcel e riusati per le nuove facce
+    std::vector<Dcel::Face*> recycledFaces;
+    std::vector<Dcel::HalfEdge*> recycledHalfEdges;
+    //Epoca dell'inserimento corrente: le facce visibili e i vertici dell'orizzonte hanno il flag uguale all'epoca
+    int visibleEpoch;
+    std::vector<Dcel::Vertex*> vertexToRemove;
+    StepCallback onStep;
+    PhaseCallback onPhase;
+    ProgressCallback onProgress;
+    //Se non è nullo e diventa true l'esecuzione si interrompe al primo punto utile
+    const std::atomic<bool>* cancelFlag;
+    //Se non è nullo registra il convex hull iniziale e ogni punto inserito (vedi ConvexHullLog)
+    ConvexHullLog* insertionLog;
+    //Se non è nullo (vedi setMeshDeltaTracking()) riceve le facce rimosse e aggiunte da findConvexHull()
+    Update* trackedUpdate;
+    Update meshDeltaUpdate;
+    int numberThreads;
+    //Thread pool creato al primo uso (vedi getThreadPool()) e riusato dalle esecuzioni successive
+    std::unique_ptr<ThreadPool> threadPool;
+    Strategy strategy;
+    bool interiorCulling;
+    InsertionOrder insertionOrder;
+    unsigned int randomSeed;
+    //Insiemi esterni della strategia QUICKHULL, riusati dalle esecuzioni successive
+    std::unique_ptr<OutsideSets> farthestOutsideSets;
+    //Stato del convex hull online (insertPoints()): gli insiemi esterni restano tra una chiamata e l'altra, i punti
+    //vengono accumulati finchè non formano un poliedro
+    std::unique_ptr<OutsideSets> onlineOutsideSets;
+    std::vector<Pointd> pendingPoints;
+    Dcel::Face* locationHint;
+    std::vector<char> addedInUpdate;
+    //Indice denso di ogni vertice e di ogni faccia (per id nella dcel) usati da getMesh()
+    mutable std::vector<int> meshVertexIndex;
+    mutable std::vector<int> meshFaceIndex;
+    mutable ConvexHullStats stats; //mutable: i contatori vengono aggiornati anche dai metodi const
 
 };
 
+/**
+ * @brief ConvexHullCore::getPoint()
+ * This method return the i-th point of vertexS, read from the input points
+ */
+inline Pointd ConvexHullCore::getPoint(int i) const{
+    return getInputPoint(vertexS[i]);
+}
+
+/**
+ * @brief ConvexHullCore::getInputPoint()
+ * This method return the input point with the given index, from the array or from the span
+ */
+inline Pointd ConvexHullCore::getInputPoint(int index) const{
+    return inputPoints != nullptr ? inputPoints[index] : inputSpan.getPoint(index);
+}
+
 #endif // CONVEXHULLCORE_H
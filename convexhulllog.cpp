@@ -0,0 +1,360 @@
+#include "convexhulllog.h"
+#include <climits>
+#include <cstring>
+#include <fstream>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+static const char MAGIC[8] = {'C', 'H', 'S', 'T', 'E', 'P', 'S', '\0'};
+static const std::uint32_t VERSION = 1;
+
+const char* const ConvexHullLog::EXTENSION = "chlog";
+
+/**
+ * @brief writeArray()
+ * This function write the elements of the vector in the file
+ */
+template <class T>
+static void writeArray(std::ofstream& file, const std::vector<T>& array){
+    file.write(reinterpret_cast<const char*>(array.data()), (std::streamsize)array.size() * sizeof(T));
+}
+
+/**
+ * @brief readArray()
+ * This function read size elements from the file in the vector
+ */
+template <class T>
+static void readArray(std::ifstream& file, std::vector<T>& array, std::uint64_t size){
+    array.resize(size);
+    file.read(reinterpret_cast<char*>(array.data()), (std::streamsize)size * sizeof(T));
+}
+
+/**
+ * @brief ConvexHullLog::ConvexHullLog()
+ * This method is the constructor of the ConvexHullLog class, the log is empty
+ */
+ConvexHullLog::ConvexHullLog(){
+    clear();
+}
+
+/**
+ * @brief ConvexHullLog::clear()
+ * This method remove all the steps and the initial convex hull
+ */
+void ConvexHullLog::clear(){
+    vertices.clear();
+    initialTriangles.clear();
+    inputIndexs.clear();
+    removedOffsets.assign(1, 0);
+    removedFaces.clear();
+    horizonOffsets.assign(1, 0);
+    horizonVertexs.clear();
+}
+
+/**
+ * @brief ConvexHullLog::addVertex()
+ * This method add the vertex of the dcel to the log
+ * @return the id of the vertex in the log
+ */
+int ConvexHullLog::addVertex(const Dcel::Vertex* vertex){
+
+    int index = vertices.size() / 3;
+    unsigned int id = vertex->getId();
+    if(id >= vertexIndex.size()){
+        vertexIndex.resize(id + 1);
+    }
+    vertexIndex[id] = index;
+    Pointd p = vertex->getCoordinate();
+    vertices.push_back(p.x());
+    vertices.push_back(p.y());
+    vertices.push_back(p.z());
+    return index;
+}
+
+/**
+ * @brief ConvexHullLog::setInitialHull()
+ * This method start a new log: the current content of the dcel (the initial tetrahedron or the degenerate convex
+ * hull, with triangular faces) is the convex hull before the first step
+ */
+void ConvexHullLog::setInitialHull(const Dcel& dcel){
+
+    clear();
+    for(Dcel::ConstVertexIterator vit = dcel.vertexBegin(); vit != dcel.vertexEnd(); ++vit){
+        addVertex(*vit);
+    }
+    for(Dcel::ConstFaceIterator fit = dcel.faceBegin(); fit != dcel.faceEnd(); ++fit){
+        unsigned int id = (*fit)->getId();
+        if(id >= faceIndex.size()){
+            faceIndex.resize(id + 1);
+        }
+        faceIndex[id] = initialTriangles.size() / 3;
+        const Dcel::HalfEdge* halfEdge = (*fit)->getOuterHalfEdge();
+        for(int k=0; k<3; k++, halfEdge = halfEdge->getNext()){
+            initialTriangles.push_back(vertexIndex[halfEdge->getFromVertex()->getId()]);
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullLog::beginStep()
+ * This method start the record of an inserted point, with its index in the input (-1 if it is not known) and the
+ * faces that it sees. It must be called before the faces are removed from the dcel, their ids could be reused
+ */
+void ConvexHullLog::beginStep(int inputIndex, const std::vector<Dcel::Face*>& removedFaces){
+
+    inputIndexs.push_back(inputIndex);
+    for(std::vector<Dcel::Face*>::const_iterator fit = removedFaces.begin(); fit != removedFaces.end(); ++fit){
+        this -> removedFaces.push_back(faceIndex[(*fit)->getId()]);
+    }
+    removedOffsets.push_back(this->removedFaces.size());
+}
+
+/**
+ * @brief ConvexHullLog::endStep()
+ * This method complete the record of an inserted point with its vertex, the ordered horizon and the new faces
+ * (the face i is built on the half edge i of the horizon, see ConvexHullCore::createNewFaces())
+ */
+void ConvexHullLog::endStep(const Dcel::Vertex* vertex, const std::vector<Dcel::HalfEdge*>& horizon, const std::vector<Dcel::Face*>& newFaces){
+
+    int firstFace = getNumberFaces();
+    addVertex(vertex);
+    for(std::vector<Dcel::HalfEdge*>::const_iterator hit = horizon.begin(); hit != horizon.end(); ++hit){
+        horizonVertexs.push_back(vertexIndex[(*hit)->getFromVertex()->getId()]);
+    }
+    horizonOffsets.push_back(horizonVertexs.size());
+
+    for(unsigned int i=0; i<newFaces.size(); i++){
+        unsigned int id = newFaces[i]->getId();
+        if(id >= faceIndex.size()){
+            faceIndex.resize(id + 1);
+        }
+        faceIndex[id] = firstFace + i;
+    }
+}
+
+/**
+ * @brief ConvexHullLog::save()
+ * This method write the log in a binary file
+ * @return True if the file was written, false otherwise
+ */
+bool ConvexHullLog::save(const std::string& filename) const{
+
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    if(!file.is_open()){
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version                = VERSION;
+    header.numberInitialTriangles = getNumberInitialTriangles();
+    header.numberInitialVertices  = getNumberInitialVertices();
+    header.numberSteps            = getNumberSteps();
+    header.numberRemovedFaces     = removedFaces.size();
+    header.numberHorizonVertexs   = horizonVertexs.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    writeArray(file, vertices);
+    writeArray(file, initialTriangles);
+    writeArray(file, inputIndexs);
+    writeArray(file, removedOffsets);
+    writeArray(file, removedFaces);
+    writeArray(file, horizonOffsets);
+    writeArray(file, horizonVertexs);
+    return file.good();
+}
+
+/**
+ * @brief ConvexHullLog::load()
+ * This method read a log written by save(), replacing the content of this one
+ * @return True if the file was read, false if it can not be opened or it is not valid
+ */
+bool ConvexHullLog::load(const std::string& filename){
+
+    clear();
+    std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+    if(!file.is_open()){
+        return false;
+    }
+    std::uint64_t fileSize = file.tellg();
+    file.seekg(0);
+    Header header;
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(Header))){
+        return false;
+    }
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION){
+        return false;
+    }
+    //Gli id sono int, un file più grande non può essere stato scritto da save()
+    if(header.numberInitialVertices + header.numberSteps > (std::uint64_t)INT_MAX / 3 || header.numberInitialTriangles > (std::uint64_t)INT_MAX / 3 ||
+       header.numberRemovedFaces > (std::uint64_t)INT_MAX || header.numberHorizonVertexs > (std::uint64_t)INT_MAX){
+        return false;
+    }
+    //Le dimensioni dell'intestazione devono corrispondere a quella del file, prima di allocare gli array
+    std::uint64_t expectedSize = sizeof(Header) + 3 * (header.numberInitialVertices + header.numberSteps) * sizeof(double) +
+                                 (3 * (std::uint64_t)header.numberInitialTriangles + 3 * header.numberSteps + 2 +
+                                  header.numberRemovedFaces + header.numberHorizonVertexs) * sizeof(int);
+    if(fileSize != expectedSize){
+        return false;
+    }
+
+    readArray(file, vertices, 3 * (header.numberInitialVertices + header.numberSteps));
+    readArray(file, initialTriangles, 3 * (std::uint64_t)header.numberInitialTriangles);
+    readArray(file, inputIndexs, header.numberSteps);
+    readArray(file, removedOffsets, header.numberSteps + 1);
+    readArray(file, removedFaces, header.numberRemovedFaces);
+    readArray(file, horizonOffsets, header.numberSteps + 1);
+    readArray(file, horizonVertexs, header.numberHorizonVertexs);
+    if(!file || !isValid()){
+        clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief ConvexHullLog::isValid()
+ * This method verify that the offsets are ordered and that the ids of the vertices and of the faces exist (a step
+ * can remove only the faces that exist before it), so a corrupted file can not be read out of the arrays
+ */
+bool ConvexHullLog::isValid() const{
+
+    for(unsigned int i=0; i<initialTriangles.size(); i++){
+        if(initialTriangles[i] < 0 || initialTriangles[i] >= getNumberInitialVertices()){
+            return false;
+        }
+    }
+    if(removedOffsets[0] != 0 || horizonOffsets[0] != 0 || removedOffsets.back() != (int) removedFaces.size() ||
+       horizonOffsets.back() != (int) horizonVertexs.size()){
+        return false;
+    }
+    for(int step=0; step<getNumberSteps(); step++){
+        if(getNumberRemovedFaces(step) < 0 || getHorizonSize(step) < 0){
+            return false;
+        }
+        for(int i=0; i<getNumberRemovedFaces(step); i++){
+            if(getRemovedFaces(step)[i] < 0 || getRemovedFaces(step)[i] >= getStepFirstFace(step)){
+                return false;
+            }
+        }
+        for(int i=0; i<getHorizonSize(step); i++){
+            if(getHorizon(step)[i] < 0 || getHorizon(step)[i] >= getStepVertex(step)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief ConvexHullLog::getNumberSteps()
+ * This method return the number of inserted points recorded in the log
+ */
+int ConvexHullLog::getNumberSteps() const{
+    return horizonOffsets.size() - 1;
+}
+
+/**
+ * @brief ConvexHullLog::getNumberVertices()
+ * This method return the number of vertices in the log: the initial ones and one for every step
+ */
+int ConvexHullLog::getNumberVertices() const{
+    return vertices.size() / 3;
+}
+
+/**
+ * @brief ConvexHullLog::getNumberInitialVertices()
+ * This method return the number of vertices of the initial convex hull
+ */
+int ConvexHullLog::getNumberInitialVertices() const{
+    return getNumberVertices() - getNumberSteps();
+}
+
+/**
+ * @brief ConvexHullLog::getNumberInitialTriangles()
+ * This method return the number of faces of the initial convex hull
+ */
+int ConvexHullLog::getNumberInitialTriangles() const{
+    return initialTriangles.size() / 3;
+}
+
+/**
+ * @brief ConvexHullLog::getNumberFaces()
+ * This method return the number of faces in the log: the initial ones and the new ones of every step
+ */
+int ConvexHullLog::getNumberFaces() const{
+    return getNumberInitialTriangles() + horizonVertexs.size();
+}
+
+/**
+ * @brief ConvexHullLog::getVertex()
+ * This method return the coordinates of a vertex of the log
+ */
+Pointd ConvexHullLog::getVertex(int vertex) const{
+    return Pointd(vertices[3*vertex], vertices[3*vertex+1], vertices[3*vertex+2]);
+}
+
+/**
+ * @brief ConvexHullLog::getInitialTriangle()
+ * This method return the 3 vertices of a face of the initial convex hull, counterclockwise seen from outside
+ */
+const int* ConvexHullLog::getInitialTriangle(int triangle) const{
+    return &initialTriangles[3*triangle];
+}
+
+/**
+ * @brief ConvexHullLog::getStepVertex()
+ * This method return the vertex inserted by the step
+ */
+int ConvexHullLog::getStepVertex(int step) const{
+    return getNumberInitialVertices() + step;
+}
+
+/**
+ * @brief ConvexHullLog::getStepInputIndex()
+ * This method return the index of the point inserted by the step in the input of the algorithm (-1 if it is not
+ * known: with the PARALLEL_DIVIDE_AND_CONQUER strategy and with the online convex hull)
+ */
+int ConvexHullLog::getStepInputIndex(int step) const{
+    return inputIndexs[step];
+}
+
+/**
+ * @brief ConvexHullLog::getStepFirstFace()
+ * This method return the first of the faces created by the step, the others follow it
+ */
+int ConvexHullLog::getStepFirstFace(int step) const{
+    return getNumberInitialTriangles() + horizonOffsets[step];
+}
+
+/**
+ * @brief ConvexHullLog::getNumberRemovedFaces()
+ * This method return the number of faces removed by the step (the faces visible by its point)
+ */
+int ConvexHullLog::getNumberRemovedFaces(int step) const{
+    return removedOffsets[step+1] - removedOffsets[step];
+}
+
+/**
+ * @brief ConvexHullLog::getRemovedFaces()
+ * This method return the faces removed by the step
+ */
+const int* ConvexHullLog::getRemovedFaces(int step) const{
+    return removedFaces.data() + removedOffsets[step];
+}
+
+/**
+ * @brief ConvexHullLog::getHorizonSize()
+ * This method return the number of edges of the horizon of the step, that is the number of faces it creates
+ */
+int ConvexHullLog::getHorizonSize(int step) const{
+    return horizonOffsets[step+1] - horizonOffsets[step];
+}
+
+/**
+ * @brief ConvexHullLog::getHorizon()
+ * This method return the cycle of the vertices of the horizon of the step
+ */
+const int* ConvexHullLog::getHorizon(int step) const{
+    return horizonVertexs.data() + horizonOffsets[step];
+}
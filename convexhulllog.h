@@ -0,0 +1,89 @@
+#ifndef CONVEXHULLLOG_H
+#define CONVEXHULLLOG_H
+
+#include "lib/dcel/dcel.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Registro della costruzione del convex hull: il convex hull        *
+ * iniziale (tetraedro o convex hull degenere) e, per ogni punto     *
+ * inserito, le sue coordinate, il suo indice tra i punti in         *
+ * ingresso, le facce rimosse e l'orizzonte. Vertici e facce hanno   *
+ * id propri, assegnati in ordine di creazione e mai riusati (quelli *
+ * della dcel vengono riusati): il vertice del passo k è             *
+ * numberInitialVertices + k e le facce nuove del passo k sono       *
+ * consecutive, una per lato dell'orizzonte. L'orizzonte è salvato   *
+ * come ciclo di vertici v0 v1 ... vn-1: la faccia nuova i è         *
+ * (v(i+1), vi, vertice del passo). Con ConvexHullPlayer qualsiasi   *
+ * convex hull intermedio si ricostruisce senza predicati.           *
+ *                                                                   *
+ * File (.chlog): intestazione di 48 byte (magic "CHSTEPS\0",        *
+ * versione e numero di triangoli iniziali uint32, numero di vertici *
+ * iniziali, di passi, di facce rimosse e di vertici degli orizzonti *
+ * uint64) seguita dagli array, con l'ordine dei byte della macchina.*
+ *********************************************************************/
+
+class ConvexHullLog{
+
+public:
+    static const char* const EXTENSION;
+
+    ConvexHullLog();
+    void clear();
+    void setInitialHull(const Dcel& dcel);
+    void beginStep(int inputIndex, const std::vector<Dcel::Face*>& removedFaces);
+    void endStep(const Dcel::Vertex* vertex, const std::vector<Dcel::HalfEdge*>& horizon, const std::vector<Dcel::Face*>& newFaces);
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    int getNumberSteps() const;
+    int getNumberVertices() const;
+    int getNumberInitialVertices() const;
+    int getNumberInitialTriangles() const;
+    int getNumberFaces() const;
+    Pointd getVertex(int vertex) const;
+    const int* getInitialTriangle(int triangle) const;
+    int getStepVertex(int step) const;
+    int getStepInputIndex(int step) const;
+    int getStepFirstFace(int step) const;
+    int getNumberRemovedFaces(int step) const;
+    const int* getRemovedFaces(int step) const;
+    int getHorizonSize(int step) const;
+    const int* getHorizon(int step) const;
+
+private:
+    struct Header{
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t numberInitialTriangles;
+        std::uint64_t numberInitialVertices;
+        std::uint64_t numberSteps;
+        std::uint64_t numberRemovedFaces;
+        std::uint64_t numberHorizonVertexs;
+    };
+
+    int addVertex(const Dcel::Vertex* vertex);
+    bool isValid() const;
+
+    //Coordinate x y z dei vertici, prima quelli iniziali e poi uno per passo
+    std::vector<double> vertices;
+    std::vector<int> initialTriangles;
+    //Per il passo k: indice del punto in ingresso (-1 se non è noto), facce rimosse in
+    //[removedOffsets[k], removedOffsets[k+1]) e orizzonte in [horizonOffsets[k], horizonOffsets[k+1])
+    std::vector<int> inputIndexs;
+    std::vector<int> removedOffsets;
+    std::vector<int> removedFaces;
+    std::vector<int> horizonOffsets;
+    std::vector<int> horizonVertexs;
+
+    //Id nel registro dei vertici e delle facce della dcel registrata (per id nella dcel), validi solo durante la registrazione
+    std::vector<int> vertexIndex;
+    std::vector<int> faceIndex;
+};
+
+#endif // CONVEXHULLLOG_H
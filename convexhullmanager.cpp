@@ -1,11 +1,31 @@
 #include "convexhullmanager.h"
 #include "ui_convexhullmanager.h"
+#include "GUI/ConvexHullCore/convexhullworker.h"
+#include "GUI/ConvexHullCore/drawableconvexhull.h"
+#include <QTimer>
+
+//Stato del calcolo asincrono: il worker che calcola il convex hull in un altro thread, il timer che ne legge
+//progresso e modifiche dal thread della GUI, il convex hull parziale disegnato mentre il worker è in esecuzione
+//e il timer che misura il tempo dell'algoritmo
+static std::unique_ptr<ConvexHullWorker> convexHullWorker;
+static DrawableConvexHull* partialConvexHull = nullptr;
+static QTimer* pollTimer = nullptr;
+static std::unique_ptr<Timer> convexHullTimer;
+static QString convexHullButtonText;
 
 ConvexHullManager::ConvexHullManager(QWidget *parent) : QFrame(parent), ui(new Ui::ConvexHullManager), mainWindow((MainWindow*)parent), drawableDcel(nullptr), dcelCHManager(nullptr) {
     ui->setupUi(this);
 }
 
 ConvexHullManager::~ConvexHullManager() {
+    // The running worker is interrupted and joined, the poll timer is deleted with this manager
+    convexHullWorker.reset();
+    pollTimer = nullptr;
+    if (partialConvexHull != nullptr){
+        mainWindow->deleteObj(partialConvexHull);
+        delete partialConvexHull;
+        partialConvexHull = nullptr;
+    }
     if (dcelCHManager != nullptr) delete dcelCHManager;
     delete ui;
 }
@@ -31,6 +51,76 @@ void ConvexHullManager::disableCHButton() {
     ui->showPhasesCheckBox->setEnabled(false);
 }
 
+/**
+ * @brief pollConvexHull
+ * This function is executed by the poll timer in the GUI thread while the ConvexHullWorker is running: it shows the
+ * progress and the changes of the partial convex hull and, when the worker has finished, the final convex hull.
+ */
+static void pollConvexHull(Ui::ConvexHullManager* ui, MainWindow* mainWindow, DrawableDcel* dcel) {
+    static std::vector<ConvexHullCore::MeshDelta> deltas;
+
+    // Only the faces removed and added since the last poll are written in the render buffer of the partial convex hull
+    if (partialConvexHull != nullptr && convexHullWorker->takeSnapshots(deltas)){
+        for (unsigned int i = 0; i < deltas.size(); i++)
+            partialConvexHull->getRenderBuffer().apply(deltas[i]);
+        mainWindow->updateGlCanvas();
+    }
+
+    if (convexHullWorker->isRunning()){
+        std::stringstream ss;
+        ss << (int) (100.0 * convexHullWorker->getProgress()) << "%";
+        ui->timeLabel->setText(ss.str().c_str());
+        return;
+    }
+    pollTimer->stop();
+    if (partialConvexHull != nullptr){
+        mainWindow->deleteObj(partialConvexHull);
+        delete partialConvexHull;
+        partialConvexHull = nullptr;
+    }
+    ui->convexHullPushButton->setText(convexHullButtonText);
+
+    convexHullTimer->stop_and_print();
+    std::stringstream ss;
+    if (convexHullWorker->isCancelled()){
+        ss << "Cancelled";
+    }
+    else {
+        ss << std::setprecision(std::numeric_limits<double>::digits10+1);
+        ss << convexHullTimer->delay();
+    }
+    ui->timeLabel->setText(ss.str().c_str());
+
+    // The drawable dcel stays the same object, only its content is replaced by the result of the worker
+    static_cast<Dcel&>(*dcel) = convexHullWorker->getResult();
+
+    // Coloring Convex hull with cyano color
+    for (Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit)
+        (*fit)->setColor(QColor(0,255,255));
+    dcel->updateBoundingBox();
+    /***
+     * Warning: updateFaceNormals() crashes if there is at least one half edge which doesn't have
+     * prev or next fields setted properly.
+     * These fields are necessary for the mesh rendering, therefore if this method crashes,
+     * you cannot view the result until all next and prev are setted properly.
+     *****/
+    dcel->updateFaceNormals();
+    /***
+     * Warning: updateVertexNormals() crashes if there is at least one half edge which doesn't have
+     * twin fields setted properly.
+     * These fields are not strictly necessary for the mesh rendering, therefore
+     * you can comment this instruction for debugging (you will see a mesh without lighting).
+     * However, when you are submitting the project, this line must be decommented.
+     * In other words: your convex hull must have all the twin fields setted properly.
+     *****/
+    //dcel->updateVertexNormals();
+
+    //Final operations to render the final dcel
+
+    dcel->update();
+    mainWindow->updateGlCanvas();
+}
+
 /**
  * @brief ConvexHullManager::on_convexHullPushButton_clicked
  * This method is executed when the "Convex Hull" button is pushed.
@@ -38,8 +128,16 @@ void ConvexHullManager::disableCHButton() {
  * The algorithm should modify the variable "dcel", which contains the input mesh, in a convex hull.
  * For the bonus point, you can check if the checkbox for the convex hull phase is checked by checking
  * "ui->showPhasesCheckBox->isChecked()". For this point, you will also need to use the variable mainwindow.
+ * The convex hull is computed by a ConvexHullWorker in another thread, so the interface stays responsive:
+ * while it is running the button cancels the computation.
  */
 void ConvexHullManager::on_convexHullPushButton_clicked() {
+    // A second click while the algorithm is running interrupts it, the result is shown by the poll timer
+    if (convexHullWorker != nullptr && convexHullWorker->isRunning()){
+        convexHullWorker->cancel();
+        return;
+    }
+
     DcelManager * manager =(DcelManager*) mainWindow->getManager(DCEL_MANAGER_ID);
     DrawableDcel * drawableDcel = manager->getDcel();
     if (drawableDcel != nullptr){
@@ -47,63 +145,57 @@ void ConvexHullManager::on_convexHullPushButton_clicked() {
             // Creating a new Manager for the Convex Hull
             dcelCHManager = new DcelManager(mainWindow);
             DCEL_CH_MANAGER_ID = mainWindow->addManager(dcelCHManager, "Dcel Convex Hull");
-            ((DcelManager*)dcelCHManager)->setDcel(*drawableDcel, "Convex Hull");
-            // dcel contains the input mesh, and it will be our convex hull
+            // The convex hull dcel starts empty: the input points are read from the input mesh, not copied with it
+            ((DcelManager*)dcelCHManager)->setDcel(Dcel(), "Convex Hull");
+            // dcel will be our convex hull
             DrawableDcel * dcel = ((DcelManager*)dcelCHManager)->getDcel();
             dcel->setFlatShading();
             dcel->setEnableTriangleColor();
 
-            Timer t("Convex Hull"); // timer
+            convexHullTimer.reset(new Timer("Convex Hull")); // timer
 
             /********************************
              * Begin Convex Hull Algorithm  *
              ********************************/
 
-                //Contiene true se il pulsante è clickato, false altrimenti
-                bool isClicked = ui->showPhasesCheckBox->isChecked();
-
-                //Creao l'oggetto Convex Hull e gli passo la dcel
-                ConvexHullCore convexHullCore(dcel,mainWindow,isClicked);
-
-                //Richiamo il metodo per calcolare il ConvexHull
-                convexHullCore.findConvexHull();
+                //Solo le coordinate dei vertici in ingresso vengono copiate, la dcel conterrà solo i vertici del convex hull
+                std::vector<double> coordinates;
+                coordinates.reserve(3 * drawableDcel->getNumberVertices());
+                for(Dcel::VertexIterator vit = drawableDcel->vertexBegin(); vit != drawableDcel->vertexEnd(); ++vit){
+                    Pointd p = (*vit)->getCoordinate();
+                    coordinates.push_back(p.x());
+                    coordinates.push_back(p.y());
+                    coordinates.push_back(p.z());
+                }
+
+                //Il worker calcola il convex hull in un altro thread; se il pulsante è clickato pubblica le modifiche del
+                //convex hull parziale al più circa 30 volte al secondo, applicate al buffer di rendering del canvas
+                if(convexHullWorker == nullptr){
+                    convexHullWorker.reset(new ConvexHullWorker());
+                }
+                convexHullWorker->setSnapshots(ui->showPhasesCheckBox->isChecked());
+                if(ui->showPhasesCheckBox->isChecked() && partialConvexHull == nullptr){
+                    partialConvexHull = new DrawableConvexHull();
+                    mainWindow->pushObj(partialConvexHull, "Partial Convex Hull");
+                }
+                convexHullWorker->start(std::move(coordinates));
 
 
             /********************************
              * End Convex Hull Algorithm    *
              ********************************/
 
-            t.stop_and_print();
-            std::stringstream ss;
-            ss << std::setprecision(std::numeric_limits<double>::digits10+1);
-            ss << t.delay();
-            ui->timeLabel->setText(ss.str().c_str());
-
-            // Coloring Convex hull with cyano color
-            for (Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit)
-                (*fit)->setColor(QColor(0,255,255));
-            dcel->updateBoundingBox();
-            /***
-             * Warning: updateFaceNormals() crashes if there is at least one half edge which doesn't have
-             * prev or next fields setted properly.
-             * These fields are necessary for the mesh rendering, therefore if this method crashes,
-             * you cannot view the result until all next and prev are setted properly.
-             *****/
-            dcel->updateFaceNormals();
-            /***
-             * Warning: updateVertexNormals() crashes if there is at least one half edge which doesn't have
-             * twin fields setted properly.
-             * These fields are not strictly necessary for the mesh rendering, therefore
-             * you can comment this instruction for debugging (you will see a mesh without lighting).
-             * However, when you are submitting the project, this line must be decommented.
-             * In other words: your convex hull must have all the twin fields setted properly.
-             *****/
-            //dcel->updateVertexNormals();
-
-            //Final operations to render the final dcel
-
-            dcel->update();
-            mainWindow->updateGlCanvas();
+            convexHullButtonText = ui->convexHullPushButton->text();
+            ui->convexHullPushButton->setText("Cancel");
+            if (pollTimer == nullptr){
+                pollTimer = new QTimer(this);
+                Ui::ConvexHullManager* ui = this->ui;
+                MainWindow* mainWindow = this->mainWindow;
+                connect(pollTimer, &QTimer::timeout, this, [ui, mainWindow, dcel](){
+                    pollConvexHull(ui, mainWindow, dcel);
+                });
+            }
+            pollTimer->start(ConvexHullWorker::DEFAULT_SNAPSHOT_INTERVAL);
         }
 
     }
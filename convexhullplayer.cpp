@@ -0,0 +1,212 @@
+#include "convexhullplayer.h"
+#include <algorithm>
+#include <unordered_map>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief ConvexHullPlayer::ConvexHullPlayer()
+ * This method is the constructor of the ConvexHullPlayer class: the vertices of all the faces of the log are
+ * computed once, the current step is the initial convex hull. The log must stay valid while the player is used
+ */
+ConvexHullPlayer::ConvexHullPlayer(const ConvexHullLog& log) : log(log){
+
+    this -> step = 0;
+    triangles.reserve(3 * log.getNumberFaces());
+    facePosition.assign(log.getNumberFaces(), -1);
+    vertexPosition.assign(log.getNumberVertices(), -1);
+    vertexFaces.assign(log.getNumberVertices(), 0);
+
+    for(int t=0; t<log.getNumberInitialTriangles(); t++){
+        const int* triangle = log.getInitialTriangle(t);
+        triangles.insert(triangles.end(), triangle, triangle + 3);
+    }
+
+    //La faccia i del passo è costruita sul lato (h[i+1], h[i]) dell'orizzonte e sul vertice del passo
+    for(int s=0; s<log.getNumberSteps(); s++){
+        const int* horizon = log.getHorizon(s);
+        int size = log.getHorizonSize(s);
+        for(int i=0; i<size; i++){
+            triangles.push_back(horizon[(i+1) % size]);
+            triangles.push_back(horizon[i]);
+            triangles.push_back(log.getStepVertex(s));
+        }
+    }
+
+    for(int t=0; t<log.getNumberInitialTriangles(); t++){
+        addFace(t);
+    }
+}
+
+/**
+ * @brief ConvexHullPlayer::getNumberSteps()
+ * This method return the number of steps of the log
+ */
+int ConvexHullPlayer::getNumberSteps() const{
+    return log.getNumberSteps();
+}
+
+/**
+ * @brief ConvexHullPlayer::getStep()
+ * This method return the number of steps applied: the current convex hull is the one after the insertion of the
+ * first getStep() points of the log
+ */
+int ConvexHullPlayer::getStep() const{
+    return step;
+}
+
+/**
+ * @brief ConvexHullPlayer::seek()
+ * This method move the current convex hull to the one after the given number of steps (from 0, the initial convex
+ * hull, to getNumberSteps(), the final one), applying the next steps or undoing the previous ones
+ */
+void ConvexHullPlayer::seek(int step){
+
+    step = std::max(0, std::min(step, getNumberSteps()));
+    while(this->step < step){
+        applyStep(this->step++);
+    }
+    while(this->step > step){
+        undoStep(--this->step);
+    }
+}
+
+/**
+ * @brief ConvexHullPlayer::applyStep()
+ * This method remove the faces seen by the point of the step and add the faces that it creates
+ */
+void ConvexHullPlayer::applyStep(int step){
+
+    const int* removedFaces = log.getRemovedFaces(step);
+    for(int i=0; i<log.getNumberRemovedFaces(step); i++){
+        removeFace(removedFaces[i]);
+    }
+    int firstFace = log.getStepFirstFace(step);
+    for(int i=0; i<log.getHorizonSize(step); i++){
+        addFace(firstFace + i);
+    }
+}
+
+/**
+ * @brief ConvexHullPlayer::undoStep()
+ * This method remove the faces created by the step and restore the faces that it removed
+ */
+void ConvexHullPlayer::undoStep(int step){
+
+    int firstFace = log.getStepFirstFace(step);
+    for(int i=0; i<log.getHorizonSize(step); i++){
+        removeFace(firstFace + i);
+    }
+    const int* removedFaces = log.getRemovedFaces(step);
+    for(int i=0; i<log.getNumberRemovedFaces(step); i++){
+        addFace(removedFaces[i]);
+    }
+}
+
+/**
+ * @brief ConvexHullPlayer::addFace()
+ * This method append the face to the live faces, and its vertices that were in no live face to the live vertices
+ */
+void ConvexHullPlayer::addFace(int face){
+
+    facePosition[face] = liveFaces.size();
+    liveFaces.push_back(face);
+    for(int k=0; k<3; k++){
+        int vertex = triangles[3*face+k];
+        if(vertexFaces[vertex]++ == 0){
+            vertexPosition[vertex] = liveVertices.size();
+            liveVertices.push_back(vertex);
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullPlayer::removeFace()
+ * This method remove the face from the live faces, and its vertices that are in no other live face from the live
+ * vertices: the last element of the list takes the place of the removed one
+ */
+void ConvexHullPlayer::removeFace(int face){
+
+    int position = facePosition[face];
+    facePosition[liveFaces.back()] = position;
+    liveFaces[position] = liveFaces.back();
+    liveFaces.pop_back();
+    facePosition[face] = -1;
+
+    for(int k=0; k<3; k++){
+        int vertex = triangles[3*face+k];
+        if(--vertexFaces[vertex] == 0){
+            int vertexIndex = vertexPosition[vertex];
+            vertexPosition[liveVertices.back()] = vertexIndex;
+            liveVertices[vertexIndex] = liveVertices.back();
+            liveVertices.pop_back();
+            vertexPosition[vertex] = -1;
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullPlayer::getMesh()
+ * This method write the current convex hull in the mesh, as ConvexHullCore::getMesh() (the options are the same).
+ * A degenerate initial convex hull without faces (a point or a segment) has only its vertices
+ */
+void ConvexHullPlayer::getMesh(ConvexHullCore::Mesh& mesh, int options) const{
+
+    mesh.vertices.clear();
+    mesh.triangles.clear();
+    mesh.planes.clear();
+    mesh.adjacency.clear();
+
+    if(log.getNumberInitialTriangles() == 0 && step == 0){
+        for(int v=0; v<log.getNumberInitialVertices(); v++){
+            Pointd p = log.getVertex(v);
+            mesh.vertices.push_back(p.x());
+            mesh.vertices.push_back(p.y());
+            mesh.vertices.push_back(p.z());
+        }
+        return;
+    }
+
+    //L'indice denso di un vertice è la sua posizione tra i vertici presenti
+    int numberVertices = liveVertices.size();
+    mesh.vertices.reserve(3 * numberVertices);
+    for(int v=0; v<numberVertices; v++){
+        Pointd p = log.getVertex(liveVertices[v]);
+        mesh.vertices.push_back(p.x());
+        mesh.vertices.push_back(p.y());
+        mesh.vertices.push_back(p.z());
+    }
+    mesh.triangles.reserve(3 * liveFaces.size());
+    for(unsigned int f=0; f<liveFaces.size(); f++){
+        for(int k=0; k<3; k++){
+            mesh.triangles.push_back(vertexPosition[triangles[3*liveFaces[f]+k]]);
+        }
+    }
+
+    if(options & ConvexHullCore::MESH_PLANES){
+        ConvexHullCore::computeMeshPlanes(mesh);
+    }
+
+    //Il triangolo adiacente al lato (a, b) è quello che contiene il lato (b, a)
+    if(options & ConvexHullCore::MESH_ADJACENCY){
+        int numberTriangles = mesh.getNumberTriangles();
+        std::unordered_map<long long, int> edges;
+        edges.reserve(3 * numberTriangles);
+        for(int t=0; t<numberTriangles; t++){
+            for(int k=0; k<3; k++){
+                long long from = mesh.triangles[3*t+k], to = mesh.triangles[3*t+(k+1)%3];
+                edges[from * numberVertices + to] = t;
+            }
+        }
+        mesh.adjacency.reserve(3 * numberTriangles);
+        for(int t=0; t<numberTriangles; t++){
+            for(int k=0; k<3; k++){
+                long long from = mesh.triangles[3*t+k], to = mesh.triangles[3*t+(k+1)%3];
+                std::unordered_map<long long, int>::const_iterator edge = edges.find(to * numberVertices + from);
+                mesh.adjacency.push_back(edge != edges.end() ? edge->second : -1);
+            }
+        }
+    }
+}
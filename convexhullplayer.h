@@ -0,0 +1,50 @@
+#ifndef CONVEXHULLPLAYER_H
+#define CONVEXHULLPLAYER_H
+
+#include "convexhullcore.h"
+#include "convexhulllog.h"
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Riproduzione di un ConvexHullLog: il convex hull dopo un passo    *
+ * qualsiasi viene ricostruito applicando (o annullando) le facce    *
+ * rimosse e create dai passi registrati, senza predicati, conflict  *
+ * graph o dcel. Spostarsi di un passo costa quanto le facce che     *
+ * il passo cambia, in avanti come all'indietro, e getMesh() costa   *
+ * quanto il convex hull corrente e non quanto tutto il registro.    *
+ *********************************************************************/
+
+class ConvexHullPlayer{
+
+public:
+    explicit ConvexHullPlayer(const ConvexHullLog& log);
+    int getNumberSteps() const;
+    int getStep() const;
+    void seek(int step);
+    void getMesh(ConvexHullCore::Mesh& mesh, int options = 0) const;
+
+private:
+    void applyStep(int step);
+    void undoStep(int step);
+    void addFace(int face);
+    void removeFace(int face);
+
+    const ConvexHullLog& log;
+    //Numero di passi applicati: 0 è il convex hull iniziale
+    int step;
+    //I 3 vertici di ogni faccia del registro, nell'ordine degli id
+    std::vector<int> triangles;
+    //Facce presenti dopo il passo corrente e posizione di ogni faccia in liveFaces (-1 se non c'è)
+    std::vector<int> liveFaces;
+    std::vector<int> facePosition;
+    //Vertici delle facce presenti, con la loro posizione in liveVertices (l'indice denso della mesh, -1 se il
+    //vertice non è in nessuna faccia) e il numero di facce presenti che li contengono
+    std::vector<int> liveVertices;
+    std::vector<int> vertexPosition;
+    std::vector<int> vertexFaces;
+};
+
+#endif // CONVEXHULLPLAYER_H
@@ -0,0 +1,166 @@
+#include "convexhullrenderbuffer.h"
+#include <algorithm>
+#include <cmath>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief ConvexHullRenderBuffer::ConvexHullRenderBuffer()
+ * This method is the constructor of the ConvexHullRenderBuffer class, the buffer starts empty
+ */
+ConvexHullRenderBuffer::ConvexHullRenderBuffer(){
+    clear();
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::clear()
+ * This method remove all the faces, the memory of the buffers is kept for the next convex hull
+ */
+void ConvexHullRenderBuffer::clear(){
+    positions.clear();
+    normals.clear();
+    faceSlots.clear();
+    freeSlots.clear();
+    this -> numberFaces = 0;
+    this -> emptyBoundingBox = true;
+    this -> boundingBoxMin = Pointd(0, 0, 0);
+    this -> boundingBoxMax = Pointd(0, 0, 0);
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::apply()
+ * This method update the buffers with the changes of the convex hull: first the removed faces are cleared, then
+ * the added faces are written in the free slots (a face id can be both removed and added by the same change).
+ * The changes must be applied in the order in which they are produced
+ */
+void ConvexHullRenderBuffer::apply(const ConvexHullCore::MeshDelta& delta){
+
+    for(unsigned int i=0; i<delta.removedFaces.size(); i++){
+        removeFace(delta.removedFaces[i]);
+    }
+    for(unsigned int i=0; i<delta.addedFaces.size(); i++){
+        addFace(delta.addedFaces[i], &delta.addedTriangles[9*i]);
+    }
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::removeFace()
+ * This method clear the slot of the face, that becomes a degenerate triangle, and make it available
+ */
+void ConvexHullRenderBuffer::removeFace(unsigned int faceId){
+
+    if(faceId >= faceSlots.size() || faceSlots[faceId] < 0){
+        return;
+    }
+    int slot = faceSlots[faceId];
+    std::fill(positions.begin() + 9*slot, positions.begin() + 9*slot + 9, 0.0f);
+    faceSlots[faceId] = -1;
+    freeSlots.push_back(slot);
+    numberFaces--;
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::addFace()
+ * This method write the face (the x y z coordinates of its 3 vertices) in a free slot, or in a new slot at the end
+ * of the buffers if there are none, with its normal
+ */
+void ConvexHullRenderBuffer::addFace(unsigned int faceId, const double* triangle){
+
+    //Un id già presente viene prima liberato, così lo slot non resta occupato da una faccia che non c'è più
+    removeFace(faceId);
+    if(faceId >= faceSlots.size()){
+        faceSlots.resize(faceId+1, -1);
+    }
+
+    int slot;
+    if(!freeSlots.empty()){
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = positions.size() / 9;
+        positions.resize(positions.size() + 9);
+        normals.resize(normals.size() + 9);
+    }
+    faceSlots[faceId] = slot;
+    numberFaces++;
+
+    //Normale del piano della faccia, i vertici sono in senso antiorario visti da fuori
+    double ux = triangle[3] - triangle[0], uy = triangle[4] - triangle[1], uz = triangle[5] - triangle[2];
+    double vx = triangle[6] - triangle[0], vy = triangle[7] - triangle[1], vz = triangle[8] - triangle[2];
+    double nx = uy*vz - uz*vy, ny = uz*vx - ux*vz, nz = ux*vy - uy*vx;
+    double length = std::sqrt(nx*nx + ny*ny + nz*nz);
+    if(length > 0){
+        nx /= length;
+        ny /= length;
+        nz /= length;
+    }
+
+    for(int k=0; k<3; k++){
+        Pointd p(triangle[3*k], triangle[3*k+1], triangle[3*k+2]);
+        positions[9*slot+3*k]   = (float) p.x();
+        positions[9*slot+3*k+1] = (float) p.y();
+        positions[9*slot+3*k+2] = (float) p.z();
+        normals[9*slot+3*k]     = (float) nx;
+        normals[9*slot+3*k+1]   = (float) ny;
+        normals[9*slot+3*k+2]   = (float) nz;
+
+        if(emptyBoundingBox){
+            boundingBoxMin = p;
+            boundingBoxMax = p;
+            emptyBoundingBox = false;
+        }
+        boundingBoxMin = Pointd(std::min(boundingBoxMin.x(), p.x()), std::min(boundingBoxMin.y(), p.y()), std::min(boundingBoxMin.z(), p.z()));
+        boundingBoxMax = Pointd(std::max(boundingBoxMax.x(), p.x()), std::max(boundingBoxMax.y(), p.y()), std::max(boundingBoxMax.z(), p.z()));
+    }
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::getNumberSlots()
+ * This method return the number of triangles in the buffers, including the degenerate ones of the free slots
+ */
+int ConvexHullRenderBuffer::getNumberSlots() const{
+    return positions.size() / 9;
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::getNumberFaces()
+ * This method return the number of faces of the convex hull
+ */
+int ConvexHullRenderBuffer::getNumberFaces() const{
+    return numberFaces;
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::getPositions()
+ * This method return the x y z coordinates of the 3 vertices of every slot (9 * getNumberSlots() values)
+ */
+const float* ConvexHullRenderBuffer::getPositions() const{
+    return positions.data();
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::getNormals()
+ * This method return the normal of every vertex of every slot (9 * getNumberSlots() values)
+ */
+const float* ConvexHullRenderBuffer::getNormals() const{
+    return normals.data();
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::getBoundingBoxMin()
+ * This method return the minimum corner of the bounding box of the vertices added since clear()
+ */
+Pointd ConvexHullRenderBuffer::getBoundingBoxMin() const{
+    return boundingBoxMin;
+}
+
+/**
+ * @brief ConvexHullRenderBuffer::getBoundingBoxMax()
+ * This method return the maximum corner of the bounding box of the vertices added since clear()
+ */
+Pointd ConvexHullRenderBuffer::getBoundingBoxMax() const{
+    return boundingBoxMax;
+}
@@ -0,0 +1,50 @@
+#ifndef CONVEXHULLRENDERBUFFER_H
+#define CONVEXHULLRENDERBUFFER_H
+
+#include "convexhullcore.h"
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Buffer di rendering del convex hull parziale, aggiornato con le   *
+ * modifiche (ConvexHullCore::MeshDelta) invece di essere ricostruito*
+ * ad ogni istantanea. Ogni faccia occupa uno slot di 3 vertici nei  *
+ * buffer di posizioni e normali (float, pronti per glDrawArrays):   *
+ * lo slot di una faccia rimossa diventa un triangolo degenere, che  *
+ * non viene disegnato, e viene riusato dalla prossima faccia        *
+ * aggiunta. Aggiornare il buffer costa quanto le facce cambiate.    *
+ *********************************************************************/
+
+class ConvexHullRenderBuffer{
+
+public:
+    ConvexHullRenderBuffer();
+    void clear();
+    void apply(const ConvexHullCore::MeshDelta& delta);
+    int getNumberSlots() const;
+    int getNumberFaces() const;
+    const float* getPositions() const;
+    const float* getNormals() const;
+    Pointd getBoundingBoxMin() const;
+    Pointd getBoundingBoxMax() const;
+
+private:
+    void removeFace(unsigned int faceId);
+    void addFace(unsigned int faceId, const double* triangle);
+
+    //Coordinate x y z e normale (ripetuta per i 3 vertici) di ogni slot
+    std::vector<float> positions;
+    std::vector<float> normals;
+    //Slot di ogni faccia (per id nella dcel, -1 se la faccia non c'è) e slot liberi
+    std::vector<int> faceSlots;
+    std::vector<int> freeSlots;
+    int numberFaces;
+    //Bounding box dei vertici aggiunti: durante la costruzione il convex hull cresce soltanto
+    bool emptyBoundingBox;
+    Pointd boundingBoxMin;
+    Pointd boundingBoxMax;
+};
+
+#endif // CONVEXHULLRENDERBUFFER_H
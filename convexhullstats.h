@@ -0,0 +1,113 @@
+#ifndef CONVEXHULLSTATS_H
+#define CONVEXHULLSTATS_H
+
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Statistiche di una esecuzione di findConvexHull(). I contatori    *
+ * vengono aggiornati solo se è definito CONVEXHULL_STATS, altrimenti*
+ * le macro CH_STATS spariscono e non costano nulla.                 *
+ *********************************************************************/
+
+#ifdef CONVEXHULL_STATS
+#define CH_STATS(statement) do { statement; } while(0)
+#else
+#define CH_STATS(statement) do { } while(0)
+#endif
+
+struct ConvexHullStats{
+
+    //Gli istogrammi hanno un bucket per ogni dimensione fino a 63, l'ultimo raccoglie tutte le dimensioni maggiori
+    static const size_t HISTOGRAM_SIZE = 65;
+
+    unsigned long long orientationTests;
+    unsigned long long exactOrientationTests;
+    unsigned long long conflictInsertions;
+    unsigned long long conflictDeletions;
+    unsigned long long insertedPoints;
+    unsigned long long interiorPoints;
+    unsigned long long culledPoints;
+    std::vector<unsigned long long> visibleFacesHistogram;
+    std::vector<unsigned long long> horizonHistogram;
+
+    //Dimensioni correnti (finali a fine esecuzione) e di picco del conflict graph
+    size_t conflicts,           peakConflicts;
+    size_t facesWithConflicts,  peakFacesWithConflicts;
+    size_t vertexWithConflicts, peakVertexWithConflicts;
+
+    ConvexHullStats(){
+        reset();
+    }
+
+    /**
+     * @brief ConvexHullStats::reset()
+     * This method set to zero all the counters
+     */
+    void reset(){
+        orientationTests        = 0;
+        exactOrientationTests   = 0;
+        conflictInsertions      = 0;
+        conflictDeletions       = 0;
+        insertedPoints          = 0;
+        interiorPoints          = 0;
+        culledPoints            = 0;
+        visibleFacesHistogram.assign(HISTOGRAM_SIZE, 0);
+        horizonHistogram.assign(HISTOGRAM_SIZE, 0);
+        conflicts               = peakConflicts           = 0;
+        facesWithConflicts      = peakFacesWithConflicts  = 0;
+        vertexWithConflicts     = peakVertexWithConflicts = 0;
+    }
+
+    /**
+     * @brief ConvexHullStats::addToHistogram()
+     * This method count a value in the histogram, the values bigger than the last bucket go in the last bucket
+     */
+    static void addToHistogram(std::vector<unsigned long long>& histogram, size_t value){
+        histogram[value < HISTOGRAM_SIZE-1 ? value : HISTOGRAM_SIZE-1]++;
+    }
+
+    /**
+     * @brief ConvexHullStats::updatePeaks()
+     * This method update the peak sizes of the conflict graph with the current ones
+     */
+    void updatePeaks(){
+        if(conflicts           > peakConflicts)           peakConflicts           = conflicts;
+        if(facesWithConflicts  > peakFacesWithConflicts)  peakFacesWithConflicts  = facesWithConflicts;
+        if(vertexWithConflicts > peakVertexWithConflicts) peakVertexWithConflicts = vertexWithConflicts;
+    }
+
+    /**
+     * @brief ConvexHullStats::print()
+     * This method print the statistics in a human readable form
+     */
+    void print(std::ostream& out) const{
+        out << "Orientation tests:      " << orientationTests   << "\n"
+            << "Exact orient. tests:    " << exactOrientationTests << "\n"
+            << "Conflict insertions:    " << conflictInsertions << "\n"
+            << "Conflict deletions:     " << conflictDeletions  << "\n"
+            << "Inserted points:        " << insertedPoints     << "\n"
+            << "Interior points:        " << interiorPoints     << "\n"
+            << "Culled points:          " << culledPoints       << "\n"
+            << "Conflicts (final/peak): " << conflicts           << "/" << peakConflicts           << "\n"
+            << "v_conflict faces (final/peak):  " << facesWithConflicts  << "/" << peakFacesWithConflicts  << "\n"
+            << "f_conflict points (final/peak): " << vertexWithConflicts << "/" << peakVertexWithConflicts << "\n";
+        printHistogram(out, "Visible faces per inserted point", visibleFacesHistogram);
+        printHistogram(out, "Horizon size per inserted point",  horizonHistogram);
+    }
+
+private:
+    static void printHistogram(std::ostream& out, const char* caption, const std::vector<unsigned long long>& histogram){
+        out << caption << ":\n";
+        for(size_t i=0; i<histogram.size(); i++){
+            if(histogram[i] == 0) continue;
+            out << "  " << i << (i == HISTOGRAM_SIZE-1 ? "+" : "") << ": " << histogram[i] << "\n";
+        }
+    }
+};
+
+#endif // CONVEXHULLSTATS_H
@@ -0,0 +1,195 @@
+#include "convexhullstream.h"
+#include "pointcloudfile.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief ConvexHullStream::ConvexHullStream()
+ * This method is the constructor of the ConvexHullStream class: the convex hull of all the points added is kept in
+ * the dcel (reset by the first block of points). chunkSize is the number of points processed together, the memory
+ * used is proportional to it and to the size of the convex hull, not to the number of points
+ */
+ConvexHullStream::ConvexHullStream(Dcel* dcel, int chunkSize) : core(dcel){
+    this -> dcel                  = dcel;
+    this -> chunkSize             = chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE;
+    this -> numberPoints          = 0;
+    this -> numberDiscardedPoints = 0;
+    chunk.reserve(this->chunkSize);
+}
+
+/**
+ * @brief ConvexHullStream::addFile()
+ * This method read the points of a file one block at a time and add them to the convex hull. The file is a binary
+ * point cloud (PointCloudFile, mapped in memory), an OBJ (only the "v x y z" lines are read) or a text file with the
+ * coordinates x y z at the start of every line (the other columns, as the intensity of a LiDAR scan, and the lines
+ * that do not start with 3 numbers are ignored)
+ * @return False if the file can not be opened, true otherwise
+ */
+bool ConvexHullStream::addFile(const std::string& filename){
+
+    size_t dot = filename.find_last_of(".");
+    std::string extension = dot != std::string::npos ? filename.substr(dot + 1) : "";
+    if(extension == PointCloudFile::EXTENSION){
+        PointCloudFile pointCloud;
+        if(!pointCloud.open(filename)){
+            return false;
+        }
+        addPoints(pointCloud.getSpan());
+        flush();
+        return true;
+    }
+
+    std::ifstream file(filename.c_str());
+    if(!file.is_open()){
+        return false;
+    }
+    bool isObj = extension == "obj";
+
+    std::string line;
+    while(std::getline(file, line)){
+        const char* begin = line.c_str();
+        if(isObj){
+            if(line.size() < 2 || line[0] != 'v' || line[1] != ' '){
+                continue;
+            }
+            begin += 2;
+        }
+        //strtod non avanza se non trova un numero: la riga viene scartata
+        char* end;
+        double x = std::strtod(begin, &end);
+        if(end == begin) continue;
+        begin = end;
+        double y = std::strtod(begin, &end);
+        if(end == begin) continue;
+        begin = end;
+        double z = std::strtod(begin, &end);
+        if(end == begin) continue;
+
+        chunk.push_back(Pointd(x, y, z));
+        if((int)chunk.size() == chunkSize){
+            processChunk();
+        }
+    }
+    flush();
+    return true;
+}
+
+/**
+ * @brief ConvexHullStream::addPoints(const Pointd *points, int numberPoints)
+ * This method add the points to the current block, every full block is processed. The points of a block that is
+ * not full are added to the convex hull by flush()
+ */
+void ConvexHullStream::addPoints(const Pointd* points, int numberPoints){
+
+    for(int i=0; i<numberPoints; ){
+        int number = std::min(numberPoints - i, chunkSize - (int)chunk.size());
+        chunk.insert(chunk.end(), points + i, points + i + number);
+        i += number;
+        if((int)chunk.size() == chunkSize){
+            processChunk();
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullStream::addPoints(const PointSpan &points)
+ * This method add the points of an array of coordinates, as addPoints(const Pointd*, int): only the block being
+ * processed is converted, so a span of a file mapped in memory is read one block at a time
+ */
+void ConvexHullStream::addPoints(const PointSpan& points){
+
+    for(int i=0; i<points.numberPoints; i++){
+        chunk.push_back(points.getPoint(i));
+        if((int)chunk.size() == chunkSize){
+            processChunk();
+        }
+    }
+}
+
+/**
+ * @brief ConvexHullStream::flush()
+ * This method process the points of the current block, after it the dcel contains the convex hull of all the
+ * points added
+ */
+void ConvexHullStream::flush(){
+    if(!chunk.empty()){
+        processChunk();
+    }
+}
+
+/**
+ * @brief ConvexHullStream::getNumberPoints()
+ * This method return the number of points processed
+ */
+unsigned long long ConvexHullStream::getNumberPoints() const{
+    return numberPoints;
+}
+
+/**
+ * @brief ConvexHullStream::getNumberDiscardedPoints()
+ * This method return the number of points discarded by the filter, without being located in the convex hull
+ */
+unsigned long long ConvexHullStream::getNumberDiscardedPoints() const{
+    return numberDiscardedPoints;
+}
+
+/**
+ * @brief ConvexHullStream::updateFilter()
+ * This method compute the planes of the polytope of the points extreme along fixed directions among the vertices
+ * of the current convex hull (see ConvexHullCore::getExtremePolytope()): the polytope is inside the convex hull,
+ * and it has a few faces, so it discards most of the interior points with a few plane evaluations. The error
+ * bounds hold for the points of the current block
+ * @return False if the convex hull is not a polyhedron yet, true otherwise
+ */
+bool ConvexHullStream::updateFilter(){
+
+    std::vector<Dcel::Vertex*> hullVertices;
+    for(Dcel::VertexIterator vit = dcel->vertexBegin(); vit != dcel->vertexEnd(); ++vit){
+        hullVertices.push_back(*vit);
+    }
+    hullBuffer.assign(hullVertices);
+    double maxAbsCoordinate = std::max(hullBuffer.getMaxAbsCoordinate(), chunkBuffer.getMaxAbsCoordinate());
+    return ConvexHullCore::getExtremePolytope(hullBuffer, maxAbsCoordinate, interiorPlanes);
+}
+
+/**
+ * @brief ConvexHullStream::processChunk()
+ * This method discard the points of the block certainly inside the filter polytope and insert the others in the
+ * convex hull, where they are located exactly (the ones inside the convex hull are discarded there)
+ */
+void ConvexHullStream::processChunk(){
+
+    int size = chunk.size();
+    numberPoints += size;
+    chunkBuffer.clear();
+    chunkBuffer.append(chunk.data(), size);
+
+    //Finchè i punti sono complanari non c'è un polytope, vengono inseriti tutti
+    if(!updateFilter()){
+        core.insertPoints(chunk.data(), size);
+        chunk.clear();
+        return;
+    }
+
+    unsigned long long tests = 0;
+    int numberInterior = ConvexHullCore::findInteriorPoints(interiorPlanes, chunkBuffer, interior, interiorBuffer, tests);
+    isInterior.assign(size, 0);
+    for(int i=0; i<numberInterior; i++){
+        isInterior[interior[i]] = 1;
+    }
+    candidates.clear();
+    for(int i=0; i<size; i++){
+        if(!isInterior[i]){
+            candidates.push_back(chunk[i]);
+        }
+    }
+    numberDiscardedPoints += numberInterior;
+
+    core.insertPoints(candidates.data(), candidates.size());
+    chunk.clear();
+}
@@ -0,0 +1,60 @@
+#ifndef CONVEXHULLSTREAM_H
+#define CONVEXHULLSTREAM_H
+
+#include "lib/dcel/dcel.h"
+#include "convexhullcore.h"
+#include "pointbuffer.h"
+#include "pointspan.h"
+#include "visibilitykernels.h"
+#include <string>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Convex hull di nuvole di punti più grandi della memoria: i punti  *
+ * arrivano a blocchi (da file o dal chiamante) e in memoria restano *
+ * solo il convex hull corrente e il blocco in elaborazione. I punti *
+ * certamente interni al polytope degli estremi del convex hull      *
+ * corrente vengono scartati con i kernel vettoriali, gli altri sono *
+ * inseriti con il convex hull online (insertPoints()).              *
+ *********************************************************************/
+
+class ConvexHullStream{
+
+public:
+    //Numero di punti di un blocco
+    static const int DEFAULT_CHUNK_SIZE = 1 << 20;
+
+    explicit ConvexHullStream(Dcel* dcel, int chunkSize = DEFAULT_CHUNK_SIZE);
+    bool addFile(const std::string& filename);
+    void addPoints(const Pointd* points, int numberPoints);
+    void addPoints(const PointSpan& points);
+    void flush();
+    unsigned long long getNumberPoints() const;
+    unsigned long long getNumberDiscardedPoints() const;
+
+private:
+    void processChunk();
+    bool updateFilter();
+
+    Dcel* dcel;
+    ConvexHullCore core;
+    int chunkSize;
+    //Blocco corrente: i punti letti e le loro coordinate SoA per i kernel
+    std::vector<Pointd> chunk;
+    PointBuffer chunkBuffer;
+    //Punti del blocco che il filtro non ha scartato, inseriti nel convex hull
+    std::vector<Pointd> candidates;
+    //Piani (con il segno cambiato) del polytope degli estremi del convex hull corrente
+    std::vector<FacePlane> interiorPlanes;
+    PointBuffer hullBuffer;
+    std::vector<int> interior;
+    std::vector<int> interiorBuffer;
+    std::vector<char> isInterior;
+    unsigned long long numberPoints;
+    unsigned long long numberDiscardedPoints;
+};
+
+#endif // CONVEXHULLSTREAM_H
@@ -0,0 +1,175 @@
+#include "convexhulltrace.h"
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+std::atomic<bool> ConvexHullTrace::enabled(false);
+std::chrono::steady_clock::time_point ConvexHullTrace::origin = std::chrono::steady_clock::now();
+
+namespace {
+
+    struct Event{
+        const char*  name;
+        std::int64_t begin;
+        std::int64_t end;
+    };
+
+    //Buffer circolare di un thread: scritto solo dal suo thread, letto da save() dopo stop()
+    struct ThreadBuffer{
+        std::vector<Event> events;
+        unsigned long long written;
+        int thread;
+        bool finished;
+    };
+
+    //Buffer di tutti i thread che hanno registrato un intervallo; quelli dei thread terminati restano fino al
+    //prossimo start(), così i thread del pool distrutti alla fine di findConvexHull() compaiono nel file
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+    int numberThreads = 0;
+    size_t bufferCapacity = ConvexHullTrace::DEFAULT_CAPACITY;
+
+    //Il buffer del thread viene segnato come terminato quando il thread finisce
+    struct LocalBuffer{
+        ThreadBuffer* buffer = nullptr;
+        ~LocalBuffer(){
+            if(buffer){
+                std::lock_guard<std::mutex> lock(registryMutex);
+                buffer -> finished = true;
+            }
+        }
+    };
+    thread_local LocalBuffer localBuffer;
+}
+
+/**
+ * @brief ConvexHullTrace::start()
+ * This method discard the intervals recorded before and start recording, keeping at most capacity intervals for
+ * every thread. It must be called when no traced code is running
+ */
+void ConvexHullTrace::start(int capacity){
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t kept = 0;
+    for(size_t i=0; i<threadBuffers.size(); i++){
+        if(!threadBuffers[i]->finished){
+            threadBuffers[i]->events.clear();
+            threadBuffers[i]->written = 0;
+            threadBuffers[kept++] = std::move(threadBuffers[i]);
+        }
+    }
+    threadBuffers.resize(kept);
+    bufferCapacity = capacity > 0 ? capacity : 1;
+    for(size_t i=0; i<threadBuffers.size(); i++){
+        threadBuffers[i]->events.reserve(bufferCapacity);
+    }
+    origin = std::chrono::steady_clock::now();
+    enabled.store(true);
+}
+
+/**
+ * @brief ConvexHullTrace::stop()
+ * This method stop recording: the intervals recorded until now can be saved with save()
+ */
+void ConvexHullTrace::stop(){
+    enabled.store(false);
+}
+
+/**
+ * @brief ConvexHullTrace::getNumberEvents()
+ * This method return the number of intervals kept in the buffers of all the threads
+ */
+long long ConvexHullTrace::getNumberEvents(){
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    long long events = 0;
+    for(size_t i=0; i<threadBuffers.size(); i++){
+        events += threadBuffers[i]->events.size();
+    }
+    return events;
+}
+
+/**
+ * @brief ConvexHullTrace::getNumberDroppedEvents()
+ * This method return the number of intervals overwritten because a buffer was full
+ */
+long long ConvexHullTrace::getNumberDroppedEvents(){
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    long long dropped = 0;
+    for(size_t i=0; i<threadBuffers.size(); i++){
+        dropped += threadBuffers[i]->written - threadBuffers[i]->events.size();
+    }
+    return dropped;
+}
+
+/**
+ * @brief ConvexHullTrace::record()
+ * This method write the interval in the buffer of the current thread, overwriting the oldest one if it is full.
+ * The buffer is registered (and its capacity allocated) the first time the thread records an interval, so the
+ * recording never allocates memory
+ */
+void ConvexHullTrace::record(const char* name, std::int64_t begin, std::int64_t end){
+
+    ThreadBuffer* buffer = localBuffer.buffer;
+    if(buffer == nullptr){
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threadBuffers.emplace_back(new ThreadBuffer());
+        buffer = threadBuffers.back().get();
+        buffer -> written  = 0;
+        buffer -> thread   = numberThreads++;
+        buffer -> finished = false;
+        buffer -> events.reserve(bufferCapacity);
+        localBuffer.buffer = buffer;
+    }
+
+    Event event = {name, begin, end};
+    if(buffer->events.size() < bufferCapacity){
+        buffer -> events.push_back(event);
+    }
+    else {
+        buffer -> events[buffer->written % buffer->events.size()] = event;
+    }
+    buffer -> written++;
+}
+
+/**
+ * @brief ConvexHullTrace::save()
+ * This method write the recorded intervals in the file, in the Chrome trace event format (JSON, with the times
+ * in microseconds from start()): it can be opened with chrome://tracing or ui.perfetto.dev. It must be called
+ * after stop()
+ * @return True if the file was written, false otherwise
+ */
+bool ConvexHullTrace::save(const std::string& filename){
+
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if(file == nullptr){
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    unsigned long long dropped = 0;
+    for(size_t i=0; i<threadBuffers.size(); i++){
+        const ThreadBuffer& buffer = *threadBuffers[i];
+        dropped += buffer.written - buffer.events.size();
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+                     first ? "" : ",\n", buffer.thread, buffer.thread);
+        first = false;
+        for(size_t e=0; e<buffer.events.size(); e++){
+            const Event& event = buffer.events[e];
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"convexhull\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         event.name, buffer.thread, event.begin / 1000.0, (event.end - event.begin) / 1000.0);
+        }
+    }
+    std::fprintf(file, "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedEvents\":%llu}}\n", dropped);
+
+    bool written = !std::ferror(file);
+    return std::fclose(file) == 0 && written;
+}
@@ -0,0 +1,98 @@
+#ifndef CONVEXHULLTRACE_H
+#define CONVEXHULLTRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Tracciamento delle fasi di findConvexHull(): ogni CH_TRACE misura *
+ * con un orologio monotono ad alta risoluzione l'intervallo fino    *
+ * alla fine del blocco e lo registra nel buffer circolare del       *
+ * thread corrente, senza lock. I buffer di tutti i thread vengono   *
+ * salvati nel formato JSON di Chrome (chrome://tracing, Perfetto),  *
+ * quindi ogni inserimento si vede sulla timeline e non solo nel     *
+ * tempo totale. Le macro CH_TRACE esistono solo se è definito       *
+ * CONVEXHULL_TRACE, altrimenti spariscono e non costano nulla; gli  *
+ * intervalli vengono registrati solo tra start() e stop().          *
+ *********************************************************************/
+
+#ifdef CONVEXHULL_TRACE
+#define CH_TRACE_CONCAT(a, b) a##b
+#define CH_TRACE_SCOPE(name, line) ConvexHullTrace::Scope CH_TRACE_CONCAT(traceScope, line)(name)
+#define CH_TRACE(name) CH_TRACE_SCOPE(name, __LINE__)
+#else
+#define CH_TRACE(name) do { } while(0)
+#endif
+
+class ConvexHullTrace{
+
+public:
+    //Intervalli conservati per ogni thread: oltre questo numero i più vecchi vengono sovrascritti
+    static const int DEFAULT_CAPACITY = 1 << 20;
+
+    //Misura l'intervallo tra la costruzione e la distruzione, il nome deve essere una stringa costante
+    class Scope{
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+    private:
+        const char* name;
+        std::int64_t begin;
+    };
+
+    static void start(int capacity = DEFAULT_CAPACITY);
+    static void stop();
+    static bool isEnabled();
+    static long long getNumberEvents();
+    static long long getNumberDroppedEvents();
+    static bool save(const std::string& filename);
+
+private:
+    static std::int64_t now();
+    static void record(const char* name, std::int64_t begin, std::int64_t end);
+
+    static std::atomic<bool> enabled;
+    static std::chrono::steady_clock::time_point origin;
+};
+
+/**
+ * @brief ConvexHullTrace::Scope::Scope()
+ * This method start the interval, if the trace is enabled
+ */
+inline ConvexHullTrace::Scope::Scope(const char* name){
+    this -> name  = isEnabled() ? name : nullptr;
+    this -> begin = this->name ? now() : 0;
+}
+
+/**
+ * @brief ConvexHullTrace::Scope::~Scope()
+ * This method end the interval and record it in the buffer of the current thread
+ */
+inline ConvexHullTrace::Scope::~Scope(){
+    if(name){
+        record(name, begin, now());
+    }
+}
+
+/**
+ * @brief ConvexHullTrace::isEnabled()
+ * This method return true between start() and stop()
+ */
+inline bool ConvexHullTrace::isEnabled(){
+    return enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief ConvexHullTrace::now()
+ * This method return the nanoseconds passed since start()
+ */
+inline std::int64_t ConvexHullTrace::now(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+#endif // CONVEXHULLTRACE_H
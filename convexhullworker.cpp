@@ -0,0 +1,186 @@
+#include "convexhullworker.h"
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief ConvexHullWorker::ConvexHullWorker()
+ * This method is the constructor of the ConvexHullWorker class. snapshotInterval is the minimum time (in
+ * milliseconds) between two snapshots of the partial convex hull
+ */
+ConvexHullWorker::ConvexHullWorker(int snapshotInterval) : core(&dcel), running(false), cancelled(false), progress(0.0){
+
+    this -> snapshots        = false;
+    this -> snapshotInterval = std::chrono::milliseconds(snapshotInterval);
+
+    core.setCancelFlag(&cancelled);
+    core.setProgressCallback([this](double progress){
+        this -> progress.store(progress, std::memory_order_relaxed);
+    });
+}
+
+/**
+ * @brief ConvexHullWorker::~ConvexHullWorker()
+ * This method interrupts the execution, if it is still running, and join the thread
+ */
+ConvexHullWorker::~ConvexHullWorker(){
+    cancel();
+    join();
+}
+
+/**
+ * @brief ConvexHullWorker::setStrategy()
+ * This method set the strategy used by the next execution (see ConvexHullCore::Strategy)
+ */
+void ConvexHullWorker::setStrategy(ConvexHullCore::Strategy strategy){
+    core.setStrategy(strategy);
+}
+
+/**
+ * @brief ConvexHullWorker::setSnapshots()
+ * This method enable or disable the snapshots of the partial convex hull for the next execution
+ */
+void ConvexHullWorker::setSnapshots(bool snapshots){
+    this -> snapshots = snapshots;
+}
+
+/**
+ * @brief ConvexHullWorker::start()
+ * This method start the computation of the convex hull of the points (x y z coordinates) in a new thread and
+ * returns immediately. The worker takes the ownership of the coordinates
+ */
+void ConvexHullWorker::start(std::vector<double>&& coordinates){
+
+    //Un'eventuale esecuzione precedente viene interrotta e attesa
+    cancel();
+    join();
+
+    this -> coordinates = std::move(coordinates);
+    cancelled.store(false);
+    progress.store(0.0);
+    pendingSnapshots.clear();
+    lastSnapshot = std::chrono::steady_clock::now();
+    core.setPoints(PointSpan(this->coordinates.data(), this->coordinates.size() / 3));
+
+    running.store(true);
+    thread = std::thread(&ConvexHullWorker::run, this);
+}
+
+/**
+ * @brief ConvexHullWorker::cancel()
+ * This method ask the thread to interrupt the execution: the algorithm stops at the next inserted point, so
+ * isRunning() becomes false shortly after
+ */
+void ConvexHullWorker::cancel(){
+    if(running.load()){
+        cancelled.store(true);
+    }
+}
+
+/**
+ * @brief ConvexHullWorker::isRunning()
+ * This method return true until the thread has finished (completed or interrupted) the execution
+ */
+bool ConvexHullWorker::isRunning() const{
+    return running.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief ConvexHullWorker::isCancelled()
+ * This method return true if the last execution was interrupted by cancel()
+ */
+bool ConvexHullWorker::isCancelled() const{
+    return cancelled.load();
+}
+
+/**
+ * @brief ConvexHullWorker::getProgress()
+ * This method return the fraction (from 0 to 1) of the work done by the current execution
+ */
+double ConvexHullWorker::getProgress() const{
+    return progress.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief ConvexHullWorker::takeSnapshots()
+ * This method give the changes of the partial convex hull published since the previous call (see
+ * ConvexHullCore::MeshDelta), in the order in which they must be applied: starting from an empty convex hull, after
+ * the last change of an execution the faces are the ones of the final convex hull. The vector is swapped with the
+ * queue, so the content it had is discarded
+ * @return True if there was at least a new change, false otherwise
+ */
+bool ConvexHullWorker::takeSnapshots(std::vector<ConvexHullCore::MeshDelta>& deltas){
+
+    deltas.clear();
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    std::swap(deltas, pendingSnapshots);
+    return !deltas.empty();
+}
+
+/**
+ * @brief ConvexHullWorker::getResult()
+ * This method wait the end of the execution and return the dcel with the convex hull (if the execution was
+ * interrupted it contains the convex hull of the points inserted until then, or it is empty)
+ */
+const Dcel& ConvexHullWorker::getResult(){
+    join();
+    return dcel;
+}
+
+/**
+ * @brief ConvexHullWorker::run()
+ * This method is executed by the thread: it find the convex hull and, if the snapshots are enabled, publish the
+ * changes of the partial convex hull after an inserted point when at least snapshotInterval has passed since the
+ * last ones were published, and the remaining changes at the end
+ */
+void ConvexHullWorker::run(){
+
+    ConvexHullCore::StepCallback onStep;
+    if(snapshots){
+        //L'intervallo parte dalla fine della pubblicazione: anche se una modifica costa più dell'intervallo, tra due
+        //modifiche l'algoritmo lavora almeno per snapshotInterval
+        onStep = [this](){
+            if(std::chrono::steady_clock::now() - lastSnapshot >= snapshotInterval){
+                publishSnapshot();
+                lastSnapshot = std::chrono::steady_clock::now();
+            }
+        };
+    }
+
+    core.setMeshDeltaTracking(snapshots);
+    core.setStepCallback(onStep);
+    core.findConvexHull();
+    if(snapshots){
+        publishSnapshot();
+    }
+
+    running.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief ConvexHullWorker::publishSnapshot()
+ * This method take the changes of the partial convex hull from the core, without locks, and then move them in the
+ * queue read by takeSnapshots(). Empty changes are not published
+ */
+void ConvexHullWorker::publishSnapshot(){
+
+    core.takeMeshDelta(backSnapshot);
+    if(backSnapshot.removedFaces.empty() && backSnapshot.addedFaces.empty()){
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    pendingSnapshots.push_back(std::move(backSnapshot));
+    backSnapshot = ConvexHullCore::MeshDelta();
+}
+
+/**
+ * @brief ConvexHullWorker::join()
+ * This method wait the end of the thread, if it was started
+ */
+void ConvexHullWorker::join(){
+    if(thread.joinable()){
+        thread.join();
+    }
+}
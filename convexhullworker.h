@@ -0,0 +1,68 @@
+#ifndef CONVEXHULLWORKER_H
+#define CONVEXHULLWORKER_H
+
+#include "lib/dcel/dcel.h"
+#include "convexhullcore.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Calcolo del convex hull in un thread separato, così l'interfaccia *
+ * resta reattiva. Il thread pubblica le modifiche del convex hull   *
+ * parziale al più una volta ogni intervallo: ogni modifica contiene *
+ * solo le facce rimosse e aggiunte dalla precedente, quindi costa   *
+ * quanto il lavoro fatto e non quanto il convex hull. Le modifiche  *
+ * vengono accodate sotto un mutex e la GUI le prende tutte con uno  *
+ * swap, applicandole nell'ordine. Progresso e interruzione sono     *
+ * atomici.                                                          *
+ *********************************************************************/
+
+class ConvexHullWorker{
+
+public:
+    //Intervallo minimo tra due istantanee, in millisecondi (circa 30 al secondo)
+    static const int DEFAULT_SNAPSHOT_INTERVAL = 33;
+
+    explicit ConvexHullWorker(int snapshotInterval = DEFAULT_SNAPSHOT_INTERVAL);
+    ~ConvexHullWorker();
+    void setStrategy(ConvexHullCore::Strategy strategy);
+    void setSnapshots(bool snapshots);
+    void start(std::vector<double>&& coordinates);
+    void cancel();
+    bool isRunning() const;
+    bool isCancelled() const;
+    double getProgress() const;
+    bool takeSnapshots(std::vector<ConvexHullCore::MeshDelta>& deltas);
+    const Dcel& getResult();
+
+private:
+    void run();
+    void publishSnapshot();
+    void join();
+
+    //Coordinate x y z dei punti in ingresso, possedute dal worker per tutta l'esecuzione
+    std::vector<double> coordinates;
+    Dcel dcel;
+    ConvexHullCore core;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<bool> cancelled;
+    std::atomic<double> progress;
+
+    //Modifiche pubblicate e non ancora prese dalla GUI, nell'ordine in cui vanno applicate; backSnapshot è scritto
+    //solo dal worker e spostato nella coda
+    bool snapshots;
+    std::chrono::milliseconds snapshotInterval;
+    std::chrono::steady_clock::time_point lastSnapshot;
+    ConvexHullCore::MeshDelta backSnapshot;
+    std::vector<ConvexHullCore::MeshDelta> pendingSnapshots;
+    std::mutex snapshotMutex;
+};
+
+#endif // CONVEXHULLWORKER_H
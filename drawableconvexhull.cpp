@@ -0,0 +1,83 @@
+#include "drawableconvexhull.h"
+
+#ifdef __APPLE__
+#include <gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief DrawableConvexHull::DrawableConvexHull()
+ * This method is the constructor of the DrawableConvexHull class, the convex hull starts empty and visible
+ */
+DrawableConvexHull::DrawableConvexHull(){
+    this -> visible = true;
+}
+
+/**
+ * @brief DrawableConvexHull::getRenderBuffer()
+ * This method return the render buffer drawn by the object: the changes applied to it are shown by the next draw()
+ */
+ConvexHullRenderBuffer& DrawableConvexHull::getRenderBuffer(){
+    return renderBuffer;
+}
+
+/**
+ * @brief DrawableConvexHull::draw()
+ * This method draw the faces of the render buffer with flat shading and the cyan color of the final convex hull
+ */
+void DrawableConvexHull::draw() const{
+
+    if(!visible || renderBuffer.getNumberSlots() == 0){
+        return;
+    }
+
+    glEnable(GL_LIGHTING);
+    glShadeModel(GL_FLAT);
+    glColor3f(0.0f, 1.0f, 1.0f);
+
+    //Gli slot liberi sono triangoli degeneri, disegnarli costa meno che compattare i buffer
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, renderBuffer.getPositions());
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, 0, renderBuffer.getNormals());
+    glDrawArrays(GL_TRIANGLES, 0, 3 * renderBuffer.getNumberSlots());
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+/**
+ * @brief DrawableConvexHull::sceneCenter()
+ * This method return the center of the bounding box of the convex hull
+ */
+Pointd DrawableConvexHull::sceneCenter() const{
+    return (renderBuffer.getBoundingBoxMin() + renderBuffer.getBoundingBoxMax()) / 2.0;
+}
+
+/**
+ * @brief DrawableConvexHull::sceneRadius()
+ * This method return half the diagonal of the bounding box of the convex hull
+ */
+double DrawableConvexHull::sceneRadius() const{
+    return renderBuffer.getBoundingBoxMin().dist(renderBuffer.getBoundingBoxMax()) / 2.0;
+}
+
+/**
+ * @brief DrawableConvexHull::isVisible()
+ * This method return true if the convex hull is drawn, false otherwise
+ */
+bool DrawableConvexHull::isVisible() const{
+    return visible;
+}
+
+/**
+ * @brief DrawableConvexHull::setVisible()
+ * This method show or hide the convex hull
+ */
+void DrawableConvexHull::setVisible(bool visible){
+    this -> visible = visible;
+}
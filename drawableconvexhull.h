@@ -0,0 +1,34 @@
+#ifndef DRAWABLECONVEXHULL_H
+#define DRAWABLECONVEXHULL_H
+
+#include "lib/common/drawable_object.h"
+#include "convexhullrenderbuffer.h"
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Oggetto disegnabile del convex hull parziale, mostrato mentre il  *
+ * ConvexHullWorker è in esecuzione: disegna il ConvexHullRenderBuffer*
+ * con un'unica glDrawArrays, senza ricostruire una DrawableDcel ad  *
+ * ogni istantanea.                                                  *
+ *********************************************************************/
+
+class DrawableConvexHull : public DrawableObject{
+
+public:
+    DrawableConvexHull();
+    ConvexHullRenderBuffer& getRenderBuffer();
+
+    void draw() const;
+    Pointd sceneCenter() const;
+    double sceneRadius() const;
+    bool isVisible() const;
+    void setVisible(bool visible);
+
+private:
+    ConvexHullRenderBuffer renderBuffer;
+    bool visible;
+};
+
+#endif // DRAWABLECONVEXHULL_H
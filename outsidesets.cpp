@@ -0,0 +1,439 @@
+#include "outsidesets.h"
+#include <cmath>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief OutsideSets::OutsideSets()
+ * This method is the constructor of the OutsideSets class, it receive the pointer of the dcel and the coordinates
+ * of the points (in the order of vertexS). As in the ConflictGraph the points are referenced by their index
+ * and the faces by their id in the dcel
+ */
+OutsideSets::OutsideSets(Dcel* dcel, const PointBuffer& points, ConvexHullStats* stats) : points(points), stats(stats){
+    this -> dcel                = dcel;
+    this -> planesMaxCoordinate = 0.0;
+    this -> plateauEpoch        = 0;
+    this -> numberPoints        = 0;
+}
+
+/**
+ * @brief OutsideSets::computePlane()
+ * This method compute (and save) the plane of a triangular face, see VisibilityKernels::computePlane()
+ * @return the plane of the face
+ */
+const FacePlane& OutsideSets::computePlane(Dcel::Face* face){
+
+    unsigned int faceId = face->getId();
+    if(faceId >= planes.size()){
+        planes.resize(faceId+1);
+        outside.resize(faceId+1);
+        interiorValues.resize(faceId+1);
+    }
+
+    Dcel::HalfEdge* halfEdge = face->getOuterHalfEdge();
+    FacePlane& plane = planes[faceId];
+    plane = VisibilityKernels::computePlane(halfEdge->getFromVertex()->getCoordinate(),
+                                            halfEdge->getNext()->getFromVertex()->getCoordinate(),
+                                            halfEdge->getNext()->getNext()->getFromVertex()->getCoordinate(),
+                                            points.getMaxAbsCoordinate());
+    planesMaxCoordinate = points.getMaxAbsCoordinate();
+    interiorValues[faceId] = -(((plane.a*interiorPoint.x() + plane.b*interiorPoint.y()) + plane.c*interiorPoint.z()) + plane.d);
+    return plane;
+}
+
+/**
+ * @brief OutsideSets::initialize()
+ * This method assign every point after the first 4 (the vertices of the tetrahedron in the dcel) to the first
+ * face of the dcel that it sees; the points that do not see any face are inside the tetrahedron and are discarded
+ */
+void OutsideSets::initialize(){
+
+    std::vector<Dcel::Face*> faces;
+    for(Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit){
+        faces.push_back(*fit);
+    }
+
+    std::vector<int> candidates;
+    for(int i=4; i<points.size(); i++){
+        candidates.push_back(i);
+    }
+    assignPoints(faces, candidates);
+}
+
+/**
+ * @brief OutsideSets::clear()
+ * This method empty the outside sets and the queue, so the object can be used for another convex hull of the
+ * same dcel. The vectors keep their memory: computing many small convex hulls does not allocate it again
+ */
+void OutsideSets::clear(){
+
+    for(unsigned int i=0; i<outside.size(); i++){
+        outside[i].points.clear();
+        outside[i].version++;
+    }
+    while(!queue.empty()){
+        queue.pop();
+    }
+    planesMaxCoordinate = 0.0;
+    numberPoints        = 0;
+}
+
+/**
+ * @brief OutsideSets::isVisible(int point, Dcel::Face *face, const FacePlane &plane, unsigned long long &exactTests)
+ * This method decide the visibility with the plane when the sign of its value is certain, otherwise with
+ * the exact orientation of the point with respect to the vertices of the face (counted in exactTests)
+ * @return True if the point is strictly on the positive side of the face, false otherwise
+ */
+bool OutsideSets::isVisible(int point, Dcel::Face* face, const FacePlane& plane, unsigned long long& exactTests) const{
+
+    double value = VisibilityKernels::evaluate(plane, points, point);
+    if(value > plane.errorBound){
+        return true;
+    }
+    if(value < -plane.errorBound){
+        return false;
+    }
+
+    exactTests++;
+    Dcel::HalfEdge* halfEdge = face->getOuterHalfEdge();
+    return Predicates::orient3d(halfEdge->getFromVertex()->getCoordinate(),
+                                halfEdge->getNext()->getFromVertex()->getCoordinate(),
+                                halfEdge->getNext()->getNext()->getFromVertex()->getCoordinate(),
+                                points.getPoint(point)) > 0.0;
+}
+
+/**
+ * @brief OutsideSets::isVisible()
+ * This method is the used to verify if the point see a face already in the outside sets
+ * @return True if the point see the face, false otherwise
+ */
+bool OutsideSets::isVisible(int point, Dcel::Face* face){
+
+    unsigned long long exactTests = 0;
+    bool visible = isVisible(point, face, planes[face->getId()], exactTests);
+    CH_STATS(if(stats){
+        stats->orientationTests++;
+        stats->exactOrientationTests += exactTests;
+    });
+    return visible;
+}
+
+/**
+ * @brief OutsideSets::getFarthestPoint()
+ * This method find, between all the faces with a not empty outside set, the one whose farthest point is the
+ * farthest of all (the distances are normalized with the length of the normal)
+ * @return False if there are no more points outside the convex hull, true otherwise
+ */
+bool OutsideSets::getFarthestPoint(Dcel::Face*& face, int& point){
+
+    while(!queue.empty()){
+        QueueEntry entry = queue.top();
+        queue.pop();
+
+        //Elemento di un insieme già svuotato o riassegnato
+        const FaceOutside& faceOutside = outside[entry.faceId];
+        if(entry.version != faceOutside.version || faceOutside.points.empty()){
+            continue;
+        }
+        face  = entry.face;
+        point = faceOutside.farthest;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief OutsideSets::takePoints()
+ * This method empty the outside sets of the faces (that are going to be removed from the dcel) and write
+ * their points, except the inserted one, in orphans
+ */
+void OutsideSets::takePoints(const std::vector<Dcel::Face*>& faces, int insertedPoint, std::vector<int>& orphans){
+
+    orphans.clear();
+    for(std::vector<Dcel::Face*>::const_iterator fit = faces.begin(); fit != faces.end(); ++fit){
+        FaceOutside& faceOutside = outside[(*fit)->getId()];
+        for(std::vector<int>::const_iterator it = faceOutside.points.begin(); it != faceOutside.points.end(); ++it){
+            if(*it != insertedPoint){
+                orphans.push_back(*it);
+            }
+        }
+        numberPoints -= faceOutside.points.size();
+        faceOutside.points.clear();
+        faceOutside.version++;
+    }
+}
+
+/**
+ * @brief OutsideSets::pushFarthest()
+ * This method put in the queue the face with the distance of its farthest point, the older elements of the face
+ * become obsolete
+ */
+void OutsideSets::pushFarthest(Dcel::Face* face, double farthest){
+
+    const FacePlane& plane = planes[face->getId()];
+    FaceOutside& faceOutside = outside[face->getId()];
+    faceOutside.version++;
+    QueueEntry entry;
+    entry.distance = farthest / std::sqrt(plane.a*plane.a + plane.b*plane.b + plane.c*plane.c);
+    entry.face     = face;
+    entry.faceId   = face->getId();
+    entry.version  = faceOutside.version;
+    queue.push(entry);
+}
+
+/**
+ * @brief OutsideSets::assignPoints()
+ * This method compute the planes of the faces and assign every candidate to the first face that it sees.
+ * The candidates are classified with the vector kernels and confirmed with the exact predicate where needed;
+ * at the end candidates contains only the points that do not see any face, which are inside the convex hull
+ */
+void OutsideSets::assignPoints(const std::vector<Dcel::Face*>& faces, std::vector<int>& candidates){
+
+    //I piani servono anche per le facce che non riceveranno punti (visita delle facce visibili)
+    for(std::vector<Dcel::Face*>::const_iterator fit = faces.begin(); fit != faces.end(); ++fit){
+        computePlane(*fit);
+    }
+
+    unsigned long long exactTests = 0;
+    for(std::vector<Dcel::Face*>::const_iterator fit = faces.begin(); fit != faces.end() && !candidates.empty(); ++fit){
+        Dcel::Face* face = *fit;
+        const FacePlane& plane = planes[face->getId()];
+        FaceOutside& faceOutside = outside[face->getId()];
+
+        int numberCandidates = candidates.size();
+        visibleBuffer.resize(numberCandidates);
+        int numberVisible = VisibilityKernels::classifyIndices(plane, points, candidates.data(), numberCandidates, -plane.errorBound, visibleBuffer.data());
+        CH_STATS(if(stats) stats->orientationTests += numberCandidates);
+
+        //I punti visibili sono una sottosequenza dei candidati: passano alla faccia, gli altri restano candidati
+        double farthest = 0.0;
+        int kept = 0, next = 0;
+        for(int i=0; i<numberCandidates; i++){
+            int point = candidates[i];
+            if(next < numberVisible && visibleBuffer[next] == point){
+                next++;
+                if(isVisible(point, face, plane, exactTests)){
+                    double distance = VisibilityKernels::evaluate(plane, points, point);
+                    if(faceOutside.points.empty() || distance > farthest){
+                        farthest             = distance;
+                        faceOutside.farthest = point;
+                    }
+                    faceOutside.points.push_back(point);
+                    continue;
+                }
+            }
+            candidates[kept++] = point;
+        }
+        numberPoints += numberCandidates - kept;
+        candidates.resize(kept);
+
+        if(!faceOutside.points.empty()){
+            pushFarthest(face, farthest);
+        }
+    }
+    CH_STATS(if(stats){
+        stats->exactOrientationTests += exactTests;
+        stats->interiorPoints        += candidates.size();
+    });
+}
+
+/**
+ * @brief OutsideSets::setInteriorPoint()
+ * This method set a point strictly inside the convex hull, used by locatePoint(). It must be called before
+ * initialize(), the point must stay inside the convex hull (for example the centroid of the first tetrahedron)
+ */
+void OutsideSets::setInteriorPoint(const Pointd& interiorPoint){
+    this -> interiorPoint = interiorPoint;
+}
+
+/**
+ * @brief OutsideSets::refreshPlanes()
+ * This method recompute the planes of all the faces of the dcel if new points (PointBuffer::append()) have
+ * coordinates bigger than the ones used for the error bounds of the planes
+ */
+void OutsideSets::refreshPlanes(){
+
+    if(points.getMaxAbsCoordinate() <= planesMaxCoordinate){
+        return;
+    }
+    for(Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit){
+        computePlane(*fit);
+    }
+}
+
+/**
+ * @brief OutsideSets::getLocationRatio()
+ * This method return the value of the plane of the face on the point divided by its value on the interior point
+ * (changed of sign): it is positive if the point see the face, -1 on the interior point
+ */
+double OutsideSets::getLocationRatio(int point, Dcel::Face* face) const{
+    unsigned int faceId = face->getId();
+    return VisibilityKernels::evaluate(planes[faceId], points, point) / interiorValues[faceId];
+}
+
+/**
+ * @brief OutsideSets::getLocationError()
+ * This method return a bound of the rounding error of a ratio of getLocationRatio() on the face: the error bound of
+ * the plane on the point and on the interior point, relative to the value on the interior point. It is infinite
+ * if the interior point is too close to the plane of the face for the sign of its value to be certain
+ */
+double OutsideSets::getLocationError(Dcel::Face* face, double ratio) const{
+    unsigned int faceId = face->getId();
+    if(interiorValues[faceId] <= planes[faceId].errorBound){
+        return INFINITY;
+    }
+    return planes[faceId].errorBound * (2.0 + std::fabs(ratio)) / interiorValues[faceId];
+}
+
+/**
+ * @brief OutsideSets::locatePoint()
+ * This method find a face of the convex hull visible by the point, starting from the face start. With c the
+ * interior point, the face f is the plane {x : v_f·(x-c) = 1} and the ratio of getLocationRatio() is v_f·(p-c) - 1:
+ * a linear function of the vertices v_f of the polar polytope, whose edges join the adjacent faces. So, as in the
+ * simplex method, moving to the adjacent face with the biggest ratio reaches the face with the biggest ratio,
+ * that is visible if and only if the point is outside the convex hull. The walk visits only the faces between
+ * start and the point. Coplanar faces have the same polar vertex, so when the walk stops all the faces with the
+ * same ratio are visited looking for a better neighbour. The ratios are rounded (see getLocationError()): two
+ * ratios closer than their errors are considered equal, so the faces with the biggest ratio are all in the visited
+ * plateau, and the point is discarded only if the ratio is below 0 by more than the errors. Otherwise, near the
+ * boundary of the convex hull, all the faces are tested with the exact predicate
+ * @return a face visible by the point, nullptr if the point is inside the convex hull
+ */
+Dcel::Face* OutsideSets::locatePoint(int point, Dcel::Face* start){
+
+    //Differenza relativa sotto cui due rapporti sono considerati uguali (facce complanari), oltre al loro errore
+    const double PLATEAU_TOLERANCE  = 1e-9;
+
+    Dcel::Face* face = start;
+    double ratio = getLocationRatio(point, face);
+    double plateauError = 0.0;
+    CH_STATS(if(stats) stats->orientationTests++);
+    while(face != nullptr){
+
+        //Salita: si passa alla faccia adiacente con il rapporto maggiore finchè ce n'è una
+        while(true){
+            Dcel::Face* next = face;
+            double nextRatio = ratio;
+            Dcel::HalfEdge* halfEdge = face->getOuterHalfEdge();
+            for(int k=0; k<3; k++, halfEdge = halfEdge->getNext()){
+                Dcel::Face* neighbour = halfEdge->getTwin()->getFace();
+                double neighbourRatio = getLocationRatio(point, neighbour);
+                if(neighbourRatio > nextRatio){
+                    next      = neighbour;
+                    nextRatio = neighbourRatio;
+                }
+            }
+            CH_STATS(if(stats) stats->orientationTests += 3);
+            if(next == face){
+                break;
+            }
+            face  = next;
+            ratio = nextRatio;
+        }
+        if(ratio > 0.0 && isVisible(point, face)){
+            return face;
+        }
+
+        //Plateau: visita delle facce con lo stesso rapporto, la salita riparte dalla prima con un vicino migliore.
+        //plateauError è il massimo errore dei rapporti delle facce del plateau
+        double error = getLocationError(face, ratio);
+        plateauError = error;
+        Dcel::Face* better = nullptr;
+        double betterRatio = ratio;
+        if(++plateauEpoch == 0){
+            plateauMark.assign(plateauMark.size(), 0);
+            plateauEpoch = 1;
+        }
+        plateau.clear();
+        plateau.push_back(face);
+        markPlateau(face);
+        for(unsigned int i=0; i<plateau.size() && better == nullptr; i++){
+            Dcel::HalfEdge* halfEdge = plateau[i]->getOuterHalfEdge();
+            for(int k=0; k<3 && better == nullptr; k++, halfEdge = halfEdge->getNext()){
+                Dcel::Face* neighbour = halfEdge->getTwin()->getFace();
+                if(isMarkedPlateau(neighbour)){
+                    continue;
+                }
+                markPlateau(neighbour);
+                double neighbourRatio = getLocationRatio(point, neighbour);
+                double neighbourError = getLocationError(neighbour, neighbourRatio);
+                double tolerance = PLATEAU_TOLERANCE * (1.0 + std::fabs(ratio)) + error + neighbourError;
+                CH_STATS(if(stats) stats->orientationTests++);
+                if(neighbourRatio > ratio + tolerance){
+                    better      = neighbour;
+                    betterRatio = neighbourRatio;
+                }else if(neighbourRatio >= ratio - tolerance){
+                    plateau.push_back(neighbour);
+                    plateauError = std::max(plateauError, neighbourError);
+                }
+            }
+        }
+        if(better == nullptr){
+            break;
+        }
+        face  = better;
+        ratio = betterRatio;
+    }
+
+    if(isVisible(point, face)){
+        return face;
+    }
+    //Le facce con il rapporto massimo sono nel plateau, dove i rapporti superano quello di face al più della tolleranza
+    if(ratio > -(PLATEAU_TOLERANCE * (1.0 + std::fabs(ratio)) + getLocationError(face, ratio) + 2.0 * plateauError)){
+        for(Dcel::FaceIterator fit = dcel->faceBegin(); fit != dcel->faceEnd(); ++fit){
+            if(isVisible(point, *fit)){
+                return *fit;
+            }
+        }
+    }
+    CH_STATS(if(stats) stats->interiorPoints++);
+    return nullptr;
+}
+
+/**
+ * @brief OutsideSets::markPlateau()
+ * This method mark the face as visited by the current visit of a plateau in locatePoint()
+ */
+void OutsideSets::markPlateau(Dcel::Face* face){
+    unsigned int faceId = face->getId();
+    if(faceId >= plateauMark.size()){
+        plateauMark.resize(faceId+1, 0);
+    }
+    plateauMark[faceId] = plateauEpoch;
+}
+
+/**
+ * @brief OutsideSets::isMarkedPlateau()
+ * This method verify if the face was already visited by the current visit of a plateau in locatePoint()
+ */
+bool OutsideSets::isMarkedPlateau(Dcel::Face* face) const{
+    unsigned int faceId = face->getId();
+    return faceId < plateauMark.size() && plateauMark[faceId] == plateauEpoch;
+}
+
+/**
+ * @brief OutsideSets::getNumberPoints()
+ * This method return the number of points in the outside sets, that is still to be inserted or discarded
+ */
+int OutsideSets::getNumberPoints() const{
+    return numberPoints;
+}
+
+/**
+ * @brief OutsideSets::addPoint()
+ * This method add a point to the outside set of a face that it sees (found with locatePoint())
+ */
+void OutsideSets::addPoint(int point, Dcel::Face* face){
+
+    FaceOutside& faceOutside = outside[face->getId()];
+    double distance = VisibilityKernels::evaluate(planes[face->getId()], points, point);
+    bool farthest = faceOutside.points.empty() || distance > VisibilityKernels::evaluate(planes[face->getId()], points, faceOutside.farthest);
+    faceOutside.points.push_back(point);
+    numberPoints++;
+    if(farthest){
+        faceOutside.farthest = point;
+        pushFarthest(face, distance);
+    }
+}
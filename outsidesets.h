@@ -0,0 +1,91 @@
+#ifndef OUTSIDESETS_H
+#define OUTSIDESETS_H
+
+#include "lib/dcel/dcel.h"
+#include "convexhullstats.h"
+#include "pointbuffer.h"
+#include "predicates.h"
+#include "visibilitykernels.h"
+#include <queue>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Insiemi esterni del Quickhull: ogni punto non ancora inserito è   *
+ * assegnato ad una sola delle facce che vede. Le facce con dei      *
+ * punti stanno in una coda con priorità ordinata per la distanza    *
+ * del loro punto più lontano, così viene espansa sempre la faccia   *
+ * con il punto più lontano tra tutti quelli ancora esterni.         *
+ *********************************************************************/
+
+class OutsideSets{
+
+public:
+    OutsideSets(Dcel* dcel, const PointBuffer& points, ConvexHullStats* stats = nullptr);
+    void initialize();
+    void clear();
+    bool getFarthestPoint(Dcel::Face*& face, int& point);
+    bool isVisible(int point, Dcel::Face* face);
+    void takePoints(const std::vector<Dcel::Face*>& faces, int insertedPoint, std::vector<int>& orphans);
+    void assignPoints(const std::vector<Dcel::Face*>& faces, std::vector<int>& candidates);
+    void setInteriorPoint(const Pointd& interiorPoint);
+    void refreshPlanes();
+    Dcel::Face* locatePoint(int point, Dcel::Face* start);
+    void addPoint(int point, Dcel::Face* face);
+    int getNumberPoints() const;
+
+private:
+    //Punti assegnati ad una faccia (indicizzata con il suo id nella dcel). La versione cambia ogni volta che l'insieme
+    //viene svuotato o riassegnato, così gli elementi della coda che si riferiscono ad un insieme vecchio vengono ignorati
+    struct FaceOutside{
+        std::vector<int> points;
+        int              farthest;
+        unsigned int     version;
+    };
+
+    //Elemento della coda: la distanza (normalizzata) del punto più lontano dalla faccia
+    struct QueueEntry{
+        double       distance;
+        Dcel::Face*  face;
+        unsigned int faceId;
+        unsigned int version;
+        bool operator<(const QueueEntry& other) const { return distance < other.distance; }
+    };
+
+    Dcel* dcel;
+    const PointBuffer& points;
+    ConvexHullStats* stats;
+
+    std::vector<FacePlane>   planes;
+
+    //Punto interno al convex hull e, per ogni faccia, il valore (cambiato di segno) del piano su di esso: il rapporto
+    //tra il valore del piano su un punto e questo valore è la funzione che locatePoint() massimizza
+    Pointd                   interiorPoint;
+    std::vector<double>      interiorValues;
+    double                   planesMaxCoordinate;
+
+    //Facce visitate durante la ricerca di un vicino migliore tra le facce con lo stesso rapporto (marcate con l'epoca)
+    std::vector<Dcel::Face*>  plateau;
+    std::vector<unsigned int> plateauMark;
+    unsigned int              plateauEpoch;
+    std::vector<FaceOutside> outside;
+    std::priority_queue<QueueEntry> queue;
+    //Numero dei punti in tutti gli insiemi esterni
+    int numberPoints;
+
+    //Buffer in cui i kernel scrivono i candidati di una faccia
+    std::vector<int> visibleBuffer;
+
+    const FacePlane& computePlane(Dcel::Face* face);
+    double getLocationRatio(int point, Dcel::Face* face) const;
+    double getLocationError(Dcel::Face* face, double ratio) const;
+    void markPlateau(Dcel::Face* face);
+    bool isMarkedPlateau(Dcel::Face* face) const;
+    void pushFarthest(Dcel::Face* face, double farthest);
+    bool isVisible(int point, Dcel::Face* face, const FacePlane& plane, unsigned long long& exactTests) const;
+
+};
+
+#endif // OUTSIDESETS_H
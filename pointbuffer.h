@@ -0,0 +1,101 @@
+#ifndef POINTBUFFER_H
+#define POINTBUFFER_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "lib/dcel/dcel.h"
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Coordinate dei punti di input memorizzate come structure of       *
+ * arrays (x, y, z contigui), nello stesso ordine di vertexS. I test *
+ * di visibilità del conflict graph leggono da qui, in modo che i    *
+ * kernel vettoriali possano caricare più punti con una sola load.   *
+ *********************************************************************/
+
+class PointBuffer{
+
+public:
+    PointBuffer(){}
+
+    /**
+     * @brief PointBuffer::assign(const std::vector<Dcel::Vertex*> &vertexS)
+     * This method copy the coordinates of the vertexs, keeping their order, and compute the biggest
+     * absolute value of the coordinates (used by the error bounds of the visibility tests)
+     */
+    void assign(const std::vector<Dcel::Vertex*>& vertexS){
+        x.resize(vertexS.size());
+        y.resize(vertexS.size());
+        z.resize(vertexS.size());
+        maxAbsCoordinate = 0.0;
+        for(unsigned int i=0; i<vertexS.size(); i++){
+            Pointd p = vertexS[i]->getCoordinate();
+            x[i] = p.x();
+            y[i] = p.y();
+            z[i] = p.z();
+            maxAbsCoordinate = std::max(maxAbsCoordinate, std::max(std::fabs(x[i]), std::max(std::fabs(y[i]), std::fabs(z[i]))));
+        }
+    }
+
+    /**
+     * @brief PointBuffer::assign(int numberPoints, const PointAccessor &getPoint)
+     * This method copy the coordinates of numberPoints points, getPoint(i) returns the i-th one
+     */
+    template <class PointAccessor>
+    void assign(int numberPoints, const PointAccessor& getPoint){
+        x.resize(numberPoints);
+        y.resize(numberPoints);
+        z.resize(numberPoints);
+        maxAbsCoordinate = 0.0;
+        for(int i=0; i<numberPoints; i++){
+            Pointd p = getPoint(i);
+            x[i] = p.x();
+            y[i] = p.y();
+            z[i] = p.z();
+            maxAbsCoordinate = std::max(maxAbsCoordinate, std::max(std::fabs(x[i]), std::max(std::fabs(y[i]), std::fabs(z[i]))));
+        }
+    }
+
+    /**
+     * @brief PointBuffer::append()
+     * This method add the coordinates of new points after the ones already in the buffer (used by the online
+     * convex hull, whose points arrive in batches), updating the biggest absolute value of the coordinates
+     */
+    void append(const Pointd* points, int numberPoints){
+        for(int i=0; i<numberPoints; i++){
+            x.push_back(points[i].x());
+            y.push_back(points[i].y());
+            z.push_back(points[i].z());
+            maxAbsCoordinate = std::max(maxAbsCoordinate, std::max(std::fabs(points[i].x()), std::max(std::fabs(points[i].y()), std::fabs(points[i].z()))));
+        }
+    }
+
+    /**
+     * @brief PointBuffer::clear()
+     * This method remove all the points but keep the biggest absolute value of the coordinates: the error bounds
+     * computed with it must hold also for the vertices of the convex hull that came from the removed points
+     */
+    void clear(){
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+
+    int size() const { return x.size(); }
+    const double* getX() const { return x.data(); }
+    const double* getY() const { return y.data(); }
+    const double* getZ() const { return z.data(); }
+    Pointd getPoint(int i) const { return Pointd(x[i], y[i], z[i]); }
+    double getMaxAbsCoordinate() const { return maxAbsCoordinate; }
+
+private:
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    double maxAbsCoordinate = 0.0;
+};
+
+#endif // POINTBUFFER_H
@@ -0,0 +1,191 @@
+#include "pointcloudfile.h"
+#include <climits>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define POINTCLOUDFILE_MMAP
+#endif
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+static const char MAGIC[8] = {'C', 'H', 'P', 'O', 'I', 'N', 'T', 'S'};
+static const std::uint32_t VERSION = 1;
+
+const char* const PointCloudFile::EXTENSION = "xyzb";
+
+/**
+ * @brief PointCloudFile::PointCloudFile()
+ * This method is the constructor of the PointCloudFile class, no file is open
+ */
+PointCloudFile::PointCloudFile(){
+    this -> mapping     = nullptr;
+    this -> mappingSize = 0;
+}
+
+/**
+ * @brief PointCloudFile::~PointCloudFile()
+ * This method unmap the file: the spans returned by getSpan() are no more valid
+ */
+PointCloudFile::~PointCloudFile(){
+    close();
+}
+
+/**
+ * @brief PointCloudFile::isValid()
+ * This method check the header and that the file contains all the coordinates it declares
+ * @return True if the file can be read, false otherwise
+ */
+bool PointCloudFile::isValid(const Header& header, std::uint64_t fileSize){
+
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION){
+        return false;
+    }
+    if(header.scalarSize != sizeof(double) && header.scalarSize != sizeof(float)){
+        return false;
+    }
+    //I punti sono indicizzati con degli int in tutto il convex hull
+    if(header.numberPoints > (std::uint64_t)INT_MAX){
+        return false;
+    }
+    return sizeof(Header) + header.numberPoints * 3 * header.scalarSize <= fileSize;
+}
+
+/**
+ * @brief PointCloudFile::open()
+ * This method map the file in memory (or read it, where the mapping is not available) and check its header.
+ * The pages are loaded by the operating system only when the points are read
+ * @return False if the file can not be opened or it is not a valid point cloud, true otherwise
+ */
+bool PointCloudFile::open(const std::string& filename){
+
+    close();
+#ifdef POINTCLOUDFILE_MMAP
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if(descriptor < 0){
+        return false;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || status.st_size < (off_t)sizeof(Header)){
+        ::close(descriptor);
+        return false;
+    }
+    void* address = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    //La mappatura resta valida anche dopo la chiusura del descrittore
+    ::close(descriptor);
+    if(address == MAP_FAILED){
+        return false;
+    }
+    //Il convex hull legge i punti in ordine, il sistema operativo può anticipare la lettura delle pagine
+    madvise(address, status.st_size, MADV_SEQUENTIAL);
+    mapping     = static_cast<const char*>(address);
+    mappingSize = status.st_size;
+#else
+    std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+    if(!file.is_open()){
+        return false;
+    }
+    std::streamoff size = file.tellg();
+    if(size < (std::streamoff)sizeof(Header)){
+        return false;
+    }
+    fallback.resize(size);
+    file.seekg(0);
+    if(!file.read(fallback.data(), size)){
+        fallback.clear();
+        return false;
+    }
+    mapping     = fallback.data();
+    mappingSize = size;
+#endif
+
+    Header header;
+    std::memcpy(&header, mapping, sizeof(Header));
+    if(!isValid(header, mappingSize)){
+        close();
+        return false;
+    }
+    span = PointSpan(mapping + sizeof(Header), (int)header.numberPoints, header.scalarSize == sizeof(float));
+    return true;
+}
+
+/**
+ * @brief PointCloudFile::close()
+ * This method unmap the file, if one is open
+ */
+void PointCloudFile::close(){
+
+#ifdef POINTCLOUDFILE_MMAP
+    if(mapping != nullptr){
+        munmap(const_cast<char*>(mapping), mappingSize);
+    }
+#endif
+    std::vector<char>().swap(fallback);
+    mapping     = nullptr;
+    mappingSize = 0;
+    span        = PointSpan();
+}
+
+/**
+ * @brief PointCloudFile::getSpan()
+ * This method return the points of the open file, read directly from the mapped memory (empty if no file is open)
+ */
+PointSpan PointCloudFile::getSpan() const{
+    return span;
+}
+
+/**
+ * @brief PointCloudFile::save(const std::string &filename, const PointSpan &points)
+ * This method write the points in a file of this format, with the precision of the span
+ * @return True if the file was written, false otherwise
+ */
+bool PointCloudFile::save(const std::string& filename, const PointSpan& points){
+
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    if(!file.is_open()){
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version      = VERSION;
+    header.scalarSize   = points.singlePrecision ? sizeof(float) : sizeof(double);
+    header.numberPoints = points.numberPoints;
+    header.reserved     = 0;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    file.write(static_cast<const char*>(points.coordinates), (std::streamsize)points.numberPoints * 3 * header.scalarSize);
+    return file.good();
+}
+
+/**
+ * @brief PointCloudFile::save(const std::string &filename, const Dcel &dcel, bool singlePrecision)
+ * This method write the vertices of the dcel (for example a mesh loaded from an OBJ or PLY file) in a file of this
+ * format, in float if singlePrecision is true and in double otherwise
+ * @return True if the file was written, false otherwise
+ */
+bool PointCloudFile::save(const std::string& filename, const Dcel& dcel, bool singlePrecision){
+
+    std::vector<double> coordinates;
+    std::vector<float> coordinatesFloat;
+    for(Dcel::ConstVertexIterator vit = dcel.vertexBegin(); vit != dcel.vertexEnd(); ++vit){
+        Pointd p = (*vit)->getCoordinate();
+        if(singlePrecision){
+            coordinatesFloat.push_back(p.x());
+            coordinatesFloat.push_back(p.y());
+            coordinatesFloat.push_back(p.z());
+        }else{
+            coordinates.push_back(p.x());
+            coordinates.push_back(p.y());
+            coordinates.push_back(p.z());
+        }
+    }
+    if(singlePrecision){
+        return save(filename, PointSpan(coordinatesFloat.data(), coordinatesFloat.size() / 3, true));
+    }
+    return save(filename, PointSpan(coordinates.data(), coordinates.size() / 3, false));
+}
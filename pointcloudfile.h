@@ -0,0 +1,61 @@
+#ifndef POINTCLOUDFILE_H
+#define POINTCLOUDFILE_H
+
+#include "lib/dcel/dcel.h"
+#include "pointspan.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Formato binario delle nuvole di punti (.xyzb): un'intestazione   *
+ * di 32 byte seguita dalle coordinate x y z impacchettate, in       *
+ * double o in float, con l'ordine dei byte della macchina (little   *
+ * endian su x86 e ARM). Il file viene mappato in memoria e i punti  *
+ * sono letti direttamente dalle pagine mappate, senza copie e senza *
+ * parsing.                                                          *
+ *                                                                   *
+ * Intestazione: magic "CHPOINTS" (8 byte), versione (uint32),       *
+ * byte per coordinata 8 o 4 (uint32), numero di punti (uint64),     *
+ * 8 byte riservati a zero (così le coordinate sono allineate a 8).  *
+ *********************************************************************/
+
+class PointCloudFile{
+
+public:
+    static const char* const EXTENSION;
+
+    PointCloudFile();
+    ~PointCloudFile();
+    bool open(const std::string& filename);
+    void close();
+    PointSpan getSpan() const;
+    static bool save(const std::string& filename, const PointSpan& points);
+    static bool save(const std::string& filename, const Dcel& dcel, bool singlePrecision = false);
+
+private:
+    struct Header{
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t scalarSize;
+        std::uint64_t numberPoints;
+        std::uint64_t reserved;
+    };
+
+    //Non copiabile: la mappatura appartiene ad un solo oggetto
+    PointCloudFile(const PointCloudFile&);
+    PointCloudFile& operator=(const PointCloudFile&);
+
+    static bool isValid(const Header& header, std::uint64_t fileSize);
+
+    const char* mapping;
+    std::size_t mappingSize;
+    //Dove il file non può essere mappato viene letto qui
+    std::vector<char> fallback;
+    PointSpan span;
+};
+
+#endif // POINTCLOUDFILE_H
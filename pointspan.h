@@ -0,0 +1,43 @@
+#ifndef POINTSPAN_H
+#define POINTSPAN_H
+
+#include <cstddef>
+#include "lib/dcel/dcel.h"
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Vista (senza copia) su un array di coordinate x y z impacchettate,*
+ * in double o in float, ad esempio un file mappato in memoria       *
+ * (PointCloudFile). Pointd ha una vtable, quindi un array di        *
+ * coordinate non può essere letto direttamente come array di Pointd.*
+ *********************************************************************/
+
+struct PointSpan{
+
+    const void* coordinates;
+    int         numberPoints;
+    bool        singlePrecision;
+
+    PointSpan(const void* coordinates = nullptr, int numberPoints = 0, bool singlePrecision = false) :
+        coordinates(coordinates), numberPoints(numberPoints), singlePrecision(singlePrecision){}
+
+    /**
+     * @brief PointSpan::getPoint()
+     * This method return the i-th point of the array
+     */
+    Pointd getPoint(int i) const{
+        if(singlePrecision){
+            const float* p = static_cast<const float*>(coordinates) + 3*(size_t)i;
+            return Pointd(p[0], p[1], p[2]);
+        }
+        const double* p = static_cast<const double*>(coordinates) + 3*(size_t)i;
+        return Pointd(p[0], p[1], p[2]);
+    }
+
+    int size() const { return numberPoints; }
+    bool empty() const { return numberPoints == 0; }
+};
+
+#endif // POINTSPAN_H
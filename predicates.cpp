@@ -0,0 +1,247 @@
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Implementazione basata su J. R. Shewchuk, "Adaptive Precision     *
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates".  *
+ * Le expansion sono somme di double non sovrapposti, in ordine di   *
+ * modulo crescente: il loro valore è rappresentato esattamente.     *
+ * La contrazione in FMA è disattivata perchè i bound dell'errore    *
+ * assumono che ogni operazione venga arrotondata separatamente.     *
+ *********************************************************************/
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#include "predicates.h"
+#include <cmath>
+
+const double Predicates::EPSILON = 1.1102230246251565e-16;
+
+//Bound dell'errore del filtro: (7 + 56 eps) eps moltiplicato per il permanente
+static const double ORIENT3D_ERROR_BOUND = (7.0 + 56.0 * Predicates::EPSILON) * Predicates::EPSILON;
+
+/**
+ * @brief twoSum()
+ * This function compute x = fl(a+b) and the rounding error y, so that a+b = x+y exactly
+ */
+static inline void twoSum(double a, double b, double& x, double& y){
+    x = a + b;
+    double bVirtual = x - a;
+    double aVirtual = x - bVirtual;
+    double bRoundoff = b - bVirtual;
+    double aRoundoff = a - aVirtual;
+    y = aRoundoff + bRoundoff;
+}
+
+/**
+ * @brief fastTwoSum()
+ * This function compute x = fl(a+b) and the rounding error y, requires |a| >= |b|
+ */
+static inline void fastTwoSum(double a, double b, double& x, double& y){
+    x = a + b;
+    double bVirtual = x - a;
+    y = b - bVirtual;
+}
+
+/**
+ * @brief twoDiff()
+ * This function compute x = fl(a-b) and the rounding error y, so that a-b = x+y exactly
+ */
+static inline void twoDiff(double a, double b, double& x, double& y){
+    x = a - b;
+    double bVirtual = a - x;
+    double aVirtual = x + bVirtual;
+    double bRoundoff = bVirtual - b;
+    double aRoundoff = a - aVirtual;
+    y = aRoundoff + bRoundoff;
+}
+
+/**
+ * @brief twoProduct()
+ * This function compute x = fl(a*b) and the rounding error y, so that a*b = x+y exactly (the fma is exact)
+ */
+static inline void twoProduct(double a, double b, double& x, double& y){
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+/**
+ * @brief difference()
+ * This function write the exact difference a-b as an expansion
+ * @return the length of the expansion
+ */
+static int difference(double a, double b, double* h){
+    double x, y;
+    twoDiff(a, b, x, y);
+    int length = 0;
+    if(y != 0.0) h[length++] = y;
+    if(x != 0.0) h[length++] = x;
+    return length;
+}
+
+/**
+ * @brief expansionSum()
+ * This function compute h = e + f, h can not be e or f. The zero components are removed
+ * @return the length of h
+ */
+static int expansionSum(int elen, const double* e, int flen, const double* f, double* h){
+    for(int i=0; i<elen; i++){
+        h[i] = e[i];
+    }
+    int hlen = elen;
+    //Ogni componente di f viene propagata lungo h (somma di Shewchuk, O(elen*flen))
+    for(int i=0; i<flen; i++){
+        double q = f[i];
+        for(int j=0; j<hlen; j++){
+            double sum, error;
+            twoSum(q, h[j], sum, error);
+            h[j] = error;
+            q = sum;
+        }
+        h[hlen++] = q;
+    }
+    //Eliminazione degli zeri
+    int length = 0;
+    for(int i=0; i<hlen; i++){
+        if(h[i] != 0.0) h[length++] = h[i];
+    }
+    return length;
+}
+
+/**
+ * @brief scaleExpansion()
+ * This function compute h = e * b, h can not be e. The zero components are removed
+ * @return the length of h
+ */
+static int scaleExpansion(int elen, const double* e, double b, double* h){
+    if(elen == 0) return 0;
+    int length = 0;
+    double q, error;
+    twoProduct(e[0], b, q, error);
+    if(error != 0.0) h[length++] = error;
+    for(int i=1; i<elen; i++){
+        double product1, product0, sum;
+        twoProduct(e[i], b, product1, product0);
+        twoSum(q, product0, sum, error);
+        if(error != 0.0) h[length++] = error;
+        fastTwoSum(product1, sum, q, error);
+        if(error != 0.0) h[length++] = error;
+    }
+    if(q != 0.0) h[length++] = q;
+    return length;
+}
+
+/**
+ * @brief multiply()
+ * This function compute h = e * f, h can not be e or f. The expansions are small (at most 16 components)
+ * @return the length of h
+ */
+static int multiply(int elen, const double* e, int flen, const double* f, double* h){
+    double scaled[32];
+    double partial[256];
+    int hlen = 0;
+    for(int i=0; i<flen; i++){
+        int slen = scaleExpansion(elen, e, f[i], scaled);
+        for(int j=0; j<hlen; j++){
+            partial[j] = h[j];
+        }
+        hlen = expansionSum(hlen, partial, slen, scaled, h);
+    }
+    return hlen;
+}
+
+/**
+ * @brief negate()
+ * This function change the sign of every component of the expansion
+ */
+static void negate(int elen, double* e){
+    for(int i=0; i<elen; i++){
+        e[i] = -e[i];
+    }
+}
+
+/**
+ * @brief minor()
+ * This function compute exactly the 2x2 minor (v1*w2 - v2*w1) of the difference expansions
+ * @return the length of the result
+ */
+static int minor(int v1len, const double* v1, int w2len, const double* w2, int v2len, const double* v2, int w1len, const double* w1, double* h){
+    double first[8], second[8];
+    int firstLength  = multiply(v1len, v1, w2len, w2, first);
+    int secondLength = multiply(v2len, v2, w1len, w1, second);
+    negate(secondLength, second);
+    return expansionSum(firstLength, first, secondLength, second, h);
+}
+
+/**
+ * @brief Predicates::orient3dExact()
+ * This method compute exactly the determinant | b-a ; c-a ; p-a |, that is ((b-a)x(c-a))·(p-a)
+ * @return the most significant component of the exact result (so its sign is the exact sign)
+ */
+double Predicates::orient3dExact(const Pointd& a, const Pointd& b, const Pointd& c, const Pointd& p){
+
+    //Differenze esatte (al più 2 componenti ciascuna)
+    double ux[2], uy[2], uz[2], vx[2], vy[2], vz[2], wx[2], wy[2], wz[2];
+    int uxl = difference(b.x(), a.x(), ux), uyl = difference(b.y(), a.y(), uy), uzl = difference(b.z(), a.z(), uz);
+    int vxl = difference(c.x(), a.x(), vx), vyl = difference(c.y(), a.y(), vy), vzl = difference(c.z(), a.z(), vz);
+    int wxl = difference(p.x(), a.x(), wx), wyl = difference(p.y(), a.y(), wy), wzl = difference(p.z(), a.z(), wz);
+
+    //u · (v x w), sviluppato lungo la prima riga
+    double m1[16], m2[16], m3[16];
+    int m1l = minor(vyl, vy, wzl, wz, vzl, vz, wyl, wy, m1);
+    int m2l = minor(vzl, vz, wxl, wx, vxl, vx, wzl, wz, m2);
+    int m3l = minor(vxl, vx, wyl, wy, vyl, vy, wxl, wx, m3);
+
+    double t1[64], t2[64], t3[64];
+    int t1l = multiply(m1l, m1, uxl, ux, t1);
+    int t2l = multiply(m2l, m2, uyl, uy, t2);
+    int t3l = multiply(m3l, m3, uzl, uz, t3);
+
+    double t12[128], determinant[192];
+    int t12l = expansionSum(t1l, t1, t2l, t2, t12);
+    int length = expansionSum(t12l, t12, t3l, t3, determinant);
+
+    return length > 0 ? determinant[length-1] : 0.0;
+}
+
+/**
+ * @brief Predicates::orient3d()
+ * This method compute the orientation of p with respect to the plane of a, b, c: positive if p is on the side
+ * of the normal (b-a)x(c-a), negative on the other side and zero if the four points are coplanar.
+ * The value is computed in double and used only if its sign is certain, otherwise it is computed exactly
+ */
+double Predicates::orient3d(const Pointd& a, const Pointd& b, const Pointd& c, const Pointd& p){
+
+    double ux = b.x()-a.x(), uy = b.y()-a.y(), uz = b.z()-a.z();
+    double vx = c.x()-a.x(), vy = c.y()-a.y(), vz = c.z()-a.z();
+    double wx = p.x()-a.x(), wy = p.y()-a.y(), wz = p.z()-a.z();
+
+    double vywz = vy*wz, vzwy = vz*wy;
+    double vzwx = vz*wx, vxwz = vx*wz;
+    double vxwy = vx*wy, vywx = vy*wx;
+
+    double det = ux*(vywz - vzwy) + uy*(vzwx - vxwz) + uz*(vxwy - vywx);
+
+    //Filtro: se il determinante supera il bound dell'errore il segno è certo
+    double permanent = (std::fabs(vywz) + std::fabs(vzwy)) * std::fabs(ux)
+                     + (std::fabs(vzwx) + std::fabs(vxwz)) * std::fabs(uy)
+                     + (std::fabs(vxwy) + std::fabs(vywx)) * std::fabs(uz);
+    double errorBound = ORIENT3D_ERROR_BOUND * permanent;
+    if(det > errorBound || -det > errorBound){
+        return det;
+    }
+
+    return orient3dExact(a, b, c, p);
+}
+
+/**
+ * @brief Predicates::orient2d()
+ * This method compute the orientation of the triangle a, b, c in the plane: positive if counterclockwise,
+ * negative if clockwise and zero if the points are collinear. The triangle is lifted to z = 0 and the apex
+ * to (ax, ay, 1), so the sign is the exact one of orient3d()
+ */
+double Predicates::orient2d(double ax, double ay, double bx, double by, double cx, double cy){
+    return orient3d(Pointd(ax, ay, 0.0), Pointd(bx, by, 0.0), Pointd(cx, cy, 0.0), Pointd(ax, ay, 1.0));
+}
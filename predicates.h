@@ -0,0 +1,31 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include "lib/common/point.h"
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Predicato di orientamento robusto. Il determinante viene prima    *
+ * calcolato in double e confrontato con un bound dell'errore di     *
+ * arrotondamento (filtro di Shewchuk); solo se il segno non è certo *
+ * viene ricalcolato in modo esatto con l'aritmetica delle expansion.*
+ * Il segno restituito è quindi sempre quello esatto, per qualunque  *
+ * scala delle coordinate (niente soglie assolute come epsilon),     *
+ * purchè i prodotti non vadano in underflow o overflow.             *
+ *********************************************************************/
+
+class Predicates{
+
+public:
+    //Epsilon di macchina nel senso di Shewchuk: 2^-53, metà di std::numeric_limits<double>::epsilon()
+    static const double EPSILON;
+
+    static double orient3d(const Pointd& a, const Pointd& b, const Pointd& c, const Pointd& p);
+    static double orient3dExact(const Pointd& a, const Pointd& b, const Pointd& c, const Pointd& p);
+    static double orient2d(double ax, double ay, double bx, double by, double cx, double cy);
+
+};
+
+#endif // PREDICATES_H
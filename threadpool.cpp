@@ -0,0 +1,147 @@
+#include "threadpool.h"
+#include "convexhulltrace.h"
+#include <algorithm>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************/
+
+/**
+ * @brief ThreadPool::ThreadPool()
+ * This method is the constructor of the ThreadPool class. numberThreads is the total number of threads
+ * used by parallelFor(), the calling thread included (0 means one for every core of the machine)
+ */
+ThreadPool::ThreadPool(int numberThreads) : queuedTasks(0), stopping(false){
+
+    if(numberThreads <= 0){
+        numberThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for(int i=0; i<numberThreads; i++){
+        queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    for(int i=1; i<numberThreads; i++){
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+/**
+ * @brief ThreadPool::~ThreadPool()
+ * This method stop and join the workers
+ */
+ThreadPool::~ThreadPool(){
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for(unsigned int i=0; i<workers.size(); i++){
+        workers[i].join();
+    }
+}
+
+/**
+ * @brief ThreadPool::getNumberThreads()
+ * This method return the number of threads that execute the tasks, the calling thread included
+ */
+int ThreadPool::getNumberThreads() const{
+    return queues.size();
+}
+
+/**
+ * @brief ThreadPool::popTask()
+ * This method take a task from the front of the given queue or, if it is empty, steal it from the back of
+ * another queue
+ * @return True if a task was found, false otherwise
+ */
+bool ThreadPool::popTask(unsigned int queue, Task& task){
+
+    for(unsigned int i=0; i<queues.size(); i++){
+        TaskQueue& current = *queues[(queue + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(current.mutex);
+        if(current.tasks.empty()){
+            continue;
+        }
+        //Dalla propria coda si prende in testa, dalle altre si ruba in fondo
+        if(i == 0){
+            task = std::move(current.tasks.front());
+            current.tasks.pop_front();
+        }else{
+            task = std::move(current.tasks.back());
+            current.tasks.pop_back();
+        }
+        queuedTasks--;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief ThreadPool::workerLoop()
+ * This method is executed by every worker: it runs the tasks while there are some, otherwise it sleeps
+ */
+void ThreadPool::workerLoop(unsigned int queue){
+
+    Task task;
+    while(true){
+        if(popTask(queue, task)){
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]{ return stopping || queuedTasks.load() > 0; });
+        if(stopping && queuedTasks.load() == 0){
+            return;
+        }
+    }
+}
+
+/**
+ * @brief ThreadPool::parallelFor()
+ * This method split [begin, end) in blocks of grain elements and execute body on every block in parallel.
+ * It returns when all the blocks are completed; the calling thread executes blocks too
+ */
+void ThreadPool::parallelFor(int begin, int end, int grain, const RangeTask& body){
+
+    if(grain < 1){
+        grain = 1;
+    }
+    int numberBlocks = (end - begin + grain - 1) / grain;
+    if(numberBlocks <= 1 || workers.empty()){
+        if(begin < end){
+            body(begin, end);
+        }
+        return;
+    }
+
+    //I blocchi vengono distribuiti a turno tra le code, poi ognuno se li contende con il work stealing
+    std::atomic<int> remaining(numberBlocks);
+    for(int i=0; i<numberBlocks; i++){
+        int blockBegin = begin + i*grain;
+        int blockEnd   = std::min(blockBegin + grain, end);
+        TaskQueue& queue = *queues[i % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back([&body, &remaining, blockBegin, blockEnd]{
+            body(blockBegin, blockEnd);
+            remaining.fetch_sub(1, std::memory_order_release);
+        });
+        queuedTasks++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_all();
+
+    //Anche il chiamante esegue i blocchi, poi aspetta quelli ancora in corso negli altri thread (l'intervallo
+    //registrato comprende l'attesa, i blocchi hanno ognuno il suo nel thread che li esegue)
+    CH_TRACE("parallelFor");
+    Task task;
+    while(remaining.load(std::memory_order_acquire) > 0){
+        if(popTask(0, task)){
+            task();
+        }else{
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Thread pool con work stealing: ogni thread ha la sua coda di      *
+ * task, prende dalla testa della propria e, quando è vuota, ruba    *
+ * dalla coda delle altre. Il thread che chiama parallelFor() lavora *
+ * anche lui finchè tutti i blocchi non sono completati.             *
+ *********************************************************************/
+
+class ThreadPool{
+
+public:
+    typedef std::function<void()> Task;
+    //Corpo di parallelFor(), riceve l'intervallo [begin, end) da elaborare
+    typedef std::function<void(int begin, int end)> RangeTask;
+
+    explicit ThreadPool(int numberThreads = 0);
+    ~ThreadPool();
+    int getNumberThreads() const;
+    void parallelFor(int begin, int end, int grain, const RangeTask& body);
+
+private:
+    struct TaskQueue{
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popTask(unsigned int queue, Task& task);
+    void workerLoop(unsigned int queue);
+
+    //La coda 0 è del thread chiamante, la coda i+1 del worker i
+    std::vector<std::unique_ptr<TaskQueue> > queues;
+    std::vector<std::thread> workers;
+    std::atomic<int> queuedTasks;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    bool stopping;
+};
+
+#endif // THREADPOOL_H
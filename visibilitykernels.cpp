@@ -0,0 +1,296 @@
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Le versioni vettoriali sono compilate con gli attributi target di *
+ * GCC/Clang, quindi non serve compilare tutto il progetto con -mavx2*
+ * e la stessa build gira anche su CPU senza AVX. La contrazione in  *
+ * FMA è disattivata: ogni versione deve arrotondare come la scalare.*
+ *********************************************************************/
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#include "visibilitykernels.h"
+#include "predicates.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VISIBILITY_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+typedef int (*ClassifyRangeFunction)(const FacePlane&, const double*, const double*, const double*, int, int, double, int*);
+typedef int (*ClassifyIndicesFunction)(const FacePlane&, const double*, const double*, const double*, const int*, int, double, int*);
+
+/**
+ * @brief evaluatePlane()
+ * This function evaluate the plane equation on a point, the order of the operations is the same of the vector kernels
+ */
+static inline double evaluatePlane(const FacePlane& plane, double x, double y, double z){
+    return ((plane.a*x + plane.b*y) + plane.c*z) + plane.d;
+}
+
+/**
+ * @brief classifyRangeScalar()
+ * Scalar version of the range kernel, used also for the tails of the vector kernels
+ */
+static int classifyRangeScalar(const FacePlane& plane, const double* x, const double* y, const double* z, int begin, int end, double threshold, int* visible){
+    int count = 0;
+    for(int i=begin; i<end; i++){
+        //Scrittura senza salto: l'indice viene sempre scritto, ma il contatore avanza solo se il punto vede la faccia
+        visible[count] = i;
+        count += evaluatePlane(plane, x[i], y[i], z[i]) > threshold;
+    }
+    return count;
+}
+
+/**
+ * @brief classifyIndicesScalar()
+ * Scalar version of the indexed kernel, used also for the tails of the vector kernels
+ */
+static int classifyIndicesScalar(const FacePlane& plane, const double* x, const double* y, const double* z, const int* indices, int number, double threshold, int* visible){
+    int count = 0;
+    for(int i=0; i<number; i++){
+        int point = indices[i];
+        visible[count] = point;
+        count += evaluatePlane(plane, x[point], y[point], z[point]) > threshold;
+    }
+    return count;
+}
+
+#ifdef VISIBILITY_KERNELS_X86
+
+/**
+ * @brief classifyRangeSse2()
+ * SSE2 version of the range kernel, 2 points for iteration
+ */
+__attribute__((target("sse2")))
+static int classifyRangeSse2(const FacePlane& plane, const double* x, const double* y, const double* z, int begin, int end, double threshold, int* visible){
+    __m128d a = _mm_set1_pd(plane.a), b = _mm_set1_pd(plane.b), c = _mm_set1_pd(plane.c), d = _mm_set1_pd(plane.d);
+    __m128d t = _mm_set1_pd(threshold);
+    int count = 0;
+    int i = begin;
+    for(; i+2 <= end; i+=2){
+        __m128d value = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(a, _mm_loadu_pd(x+i)), _mm_mul_pd(b, _mm_loadu_pd(y+i))), _mm_mul_pd(c, _mm_loadu_pd(z+i))), d);
+        int mask = _mm_movemask_pd(_mm_cmpgt_pd(value, t));
+        visible[count] = i;   count +=  mask     & 1;
+        visible[count] = i+1; count += (mask>>1) & 1;
+    }
+    return count + classifyRangeScalar(plane, x, y, z, i, end, threshold, visible + count);
+}
+
+/**
+ * @brief classifyIndicesSse2()
+ * SSE2 version of the indexed kernel, 2 points for iteration (SSE2 has no gather, the loads are scalar)
+ */
+__attribute__((target("sse2")))
+static int classifyIndicesSse2(const FacePlane& plane, const double* x, const double* y, const double* z, const int* indices, int number, double threshold, int* visible){
+    __m128d a = _mm_set1_pd(plane.a), b = _mm_set1_pd(plane.b), c = _mm_set1_pd(plane.c), d = _mm_set1_pd(plane.d);
+    __m128d t = _mm_set1_pd(threshold);
+    int count = 0;
+    int i = 0;
+    for(; i+2 <= number; i+=2){
+        int p0 = indices[i], p1 = indices[i+1];
+        __m128d px = _mm_set_pd(x[p1], x[p0]);
+        __m128d py = _mm_set_pd(y[p1], y[p0]);
+        __m128d pz = _mm_set_pd(z[p1], z[p0]);
+        __m128d value = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(a, px), _mm_mul_pd(b, py)), _mm_mul_pd(c, pz)), d);
+        int mask = _mm_movemask_pd(_mm_cmpgt_pd(value, t));
+        visible[count] = p0; count +=  mask     & 1;
+        visible[count] = p1; count += (mask>>1) & 1;
+    }
+    return count + classifyIndicesScalar(plane, x, y, z, indices+i, number-i, threshold, visible + count);
+}
+
+/**
+ * @brief classifyRangeAvx2()
+ * AVX2 version of the range kernel, 4 points for iteration
+ */
+__attribute__((target("avx2")))
+static int classifyRangeAvx2(const FacePlane& plane, const double* x, const double* y, const double* z, int begin, int end, double threshold, int* visible){
+    __m256d a = _mm256_set1_pd(plane.a), b = _mm256_set1_pd(plane.b), c = _mm256_set1_pd(plane.c), d = _mm256_set1_pd(plane.d);
+    __m256d t = _mm256_set1_pd(threshold);
+    int count = 0;
+    int i = begin;
+    for(; i+4 <= end; i+=4){
+        __m256d value = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, _mm256_loadu_pd(x+i)), _mm256_mul_pd(b, _mm256_loadu_pd(y+i))), _mm256_mul_pd(c, _mm256_loadu_pd(z+i))), d);
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(value, t, _CMP_GT_OQ));
+        visible[count] = i;   count +=  mask     & 1;
+        visible[count] = i+1; count += (mask>>1) & 1;
+        visible[count] = i+2; count += (mask>>2) & 1;
+        visible[count] = i+3; count += (mask>>3) & 1;
+    }
+    return count + classifyRangeScalar(plane, x, y, z, i, end, threshold, visible + count);
+}
+
+/**
+ * @brief classifyIndicesAvx2()
+ * AVX2 version of the indexed kernel, 4 points for iteration loaded with gather
+ */
+__attribute__((target("avx2")))
+static int classifyIndicesAvx2(const FacePlane& plane, const double* x, const double* y, const double* z, const int* indices, int number, double threshold, int* visible){
+    __m256d a = _mm256_set1_pd(plane.a), b = _mm256_set1_pd(plane.b), c = _mm256_set1_pd(plane.c), d = _mm256_set1_pd(plane.d);
+    __m256d t = _mm256_set1_pd(threshold);
+    int count = 0;
+    int i = 0;
+    for(; i+4 <= number; i+=4){
+        __m128i index = _mm_loadu_si128((const __m128i*)(indices+i));
+        __m256d px = _mm256_i32gather_pd(x, index, 8);
+        __m256d py = _mm256_i32gather_pd(y, index, 8);
+        __m256d pz = _mm256_i32gather_pd(z, index, 8);
+        __m256d value = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a, px), _mm256_mul_pd(b, py)), _mm256_mul_pd(c, pz)), d);
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(value, t, _CMP_GT_OQ));
+        visible[count] = indices[i];   count +=  mask     & 1;
+        visible[count] = indices[i+1]; count += (mask>>1) & 1;
+        visible[count] = indices[i+2]; count += (mask>>2) & 1;
+        visible[count] = indices[i+3]; count += (mask>>3) & 1;
+    }
+    return count + classifyIndicesScalar(plane, x, y, z, indices+i, number-i, threshold, visible + count);
+}
+
+/**
+ * @brief classifyRangeAvx512()
+ * AVX-512 version of the range kernel, 8 points for iteration compacted with compress store
+ */
+__attribute__((target("avx512f")))
+static int classifyRangeAvx512(const FacePlane& plane, const double* x, const double* y, const double* z, int begin, int end, double threshold, int* visible){
+    __m512d a = _mm512_set1_pd(plane.a), b = _mm512_set1_pd(plane.b), c = _mm512_set1_pd(plane.c), d = _mm512_set1_pd(plane.d);
+    __m512d t = _mm512_set1_pd(threshold);
+    __m512i step = _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0, 7, 6, 5, 4, 3, 2, 1, 0);
+    int count = 0;
+    int i = begin;
+    for(; i+8 <= end; i+=8){
+        __m512d value = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(a, _mm512_loadu_pd(x+i)), _mm512_mul_pd(b, _mm512_loadu_pd(y+i))), _mm512_mul_pd(c, _mm512_loadu_pd(z+i))), d);
+        __mmask8 mask = _mm512_cmp_pd_mask(value, t, _CMP_GT_OQ);
+        __m512i index = _mm512_add_epi32(_mm512_set1_epi32(i), step);
+        _mm512_mask_compressstoreu_epi32(visible + count, (__mmask16)mask, index);
+        count += __builtin_popcount(mask);
+    }
+    return count + classifyRangeScalar(plane, x, y, z, i, end, threshold, visible + count);
+}
+
+/**
+ * @brief classifyIndicesAvx512()
+ * AVX-512 version of the indexed kernel, 8 points for iteration loaded with gather and compacted with compress store
+ */
+__attribute__((target("avx512f")))
+static int classifyIndicesAvx512(const FacePlane& plane, const double* x, const double* y, const double* z, const int* indices, int number, double threshold, int* visible){
+    __m512d a = _mm512_set1_pd(plane.a), b = _mm512_set1_pd(plane.b), c = _mm512_set1_pd(plane.c), d = _mm512_set1_pd(plane.d);
+    __m512d t = _mm512_set1_pd(threshold);
+    int count = 0;
+    int i = 0;
+    for(; i+8 <= number; i+=8){
+        __m256i index = _mm256_loadu_si256((const __m256i*)(indices+i));
+        __m512d px = _mm512_i32gather_pd(index, x, 8);
+        __m512d py = _mm512_i32gather_pd(index, y, 8);
+        __m512d pz = _mm512_i32gather_pd(index, z, 8);
+        __m512d value = _mm512_add_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(a, px), _mm512_mul_pd(b, py)), _mm512_mul_pd(c, pz)), d);
+        __mmask8 mask = _mm512_cmp_pd_mask(value, t, _CMP_GT_OQ);
+        _mm512_mask_compressstoreu_epi32(visible + count, (__mmask16)mask, _mm512_castsi256_si512(index));
+        count += __builtin_popcount(mask);
+    }
+    return count + classifyIndicesScalar(plane, x, y, z, indices+i, number-i, threshold, visible + count);
+}
+
+#endif
+
+/**
+ * @brief Kernels
+ * The kernels chosen for the current CPU, selected once at the first use
+ */
+struct Kernels{
+    ClassifyRangeFunction   classifyRange;
+    ClassifyIndicesFunction classifyIndices;
+    const char*             instructionSet;
+
+    Kernels(){
+        classifyRange   = classifyRangeScalar;
+        classifyIndices = classifyIndicesScalar;
+        instructionSet  = "scalar";
+#ifdef VISIBILITY_KERNELS_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f")){
+            classifyRange   = classifyRangeAvx512;
+            classifyIndices = classifyIndicesAvx512;
+            instructionSet  = "avx512";
+        }else if(__builtin_cpu_supports("avx2")){
+            classifyRange   = classifyRangeAvx2;
+            classifyIndices = classifyIndicesAvx2;
+            instructionSet  = "avx2";
+        }else if(__builtin_cpu_supports("sse2")){
+            classifyRange   = classifyRangeSse2;
+            classifyIndices = classifyIndicesSse2;
+            instructionSet  = "sse2";
+        }
+#endif
+    }
+};
+
+static const Kernels& getKernels(){
+    static const Kernels kernels;
+    return kernels;
+}
+
+/**
+ * @brief VisibilityKernels::computePlane()
+ * This method compute the plane of the triangle p0, p1, p2 (normal (p1-p0)x(p2-p0), so the points with a positive
+ * value are the ones with Predicates::orient3d(p0, p1, p2, p) > 0) and the bound of the rounding error of its
+ * evaluation on any point with coordinates not bigger than maxAbsCoordinate in absolute value
+ */
+FacePlane VisibilityKernels::computePlane(const Pointd& p0, const Pointd& p1, const Pointd& p2, double maxAbsCoordinate){
+    //Normale con il prodotto vettoriale, poi offset in modo che il piano passi per p0
+    double ux = p1.x()-p0.x(), uy = p1.y()-p0.y(), uz = p1.z()-p0.z();
+    double vx = p2.x()-p0.x(), vy = p2.y()-p0.y(), vz = p2.z()-p0.z();
+
+    FacePlane plane;
+    plane.a = uy*vz - uz*vy;
+    plane.b = uz*vx - ux*vz;
+    plane.c = ux*vy - uy*vx;
+    plane.d = -(plane.a*p0.x() + plane.b*p0.y() + plane.c*p0.z());
+
+    //Bound dell'errore: la normale calcolata differisce da quella esatta al più di 5 eps per il permanente dei
+    //prodotti, l'offset e la valutazione del piano aggiungono al più 4+3 eps sui moduli dei termini. Con M il
+    //massimo modulo delle coordinate (|p - p0| <= 2M) le costanti usate sono abbondanti rispetto a queste
+    double permanent      = std::fabs(uy*vz) + std::fabs(uz*vy) + std::fabs(uz*vx) + std::fabs(ux*vz) + std::fabs(ux*vy) + std::fabs(uy*vx);
+    double normalAbs      = std::fabs(plane.a) + std::fabs(plane.b) + std::fabs(plane.c);
+    plane.errorBound = Predicates::EPSILON * (12.0 * maxAbsCoordinate * permanent + 8.0 * (maxAbsCoordinate * normalAbs + std::fabs(plane.d)));
+    return plane;
+}
+
+/**
+ * @brief VisibilityKernels::evaluate()
+ * This method evaluate the plane equation on a single point
+ * @return a positive value if the point is on the visible side of the plane
+ */
+double VisibilityKernels::evaluate(const FacePlane& plane, const PointBuffer& points, int point){
+    return evaluatePlane(plane, points.getX()[point], points.getY()[point], points.getZ()[point]);
+}
+
+/**
+ * @brief VisibilityKernels::classifyRange()
+ * This method classify the points with index in [begin, end) against the plane. The indices of the points
+ * with plane value > threshold are written, compacted, in visible, that must have room for end-begin indices
+ * @return the number of points that see the plane
+ */
+int VisibilityKernels::classifyRange(const FacePlane& plane, const PointBuffer& points, int begin, int end, double threshold, int* visible){
+    return getKernels().classifyRange(plane, points.getX(), points.getY(), points.getZ(), begin, end, threshold, visible);
+}
+
+/**
+ * @brief VisibilityKernels::classifyIndices()
+ * This method classify the count points listed in indices against the plane. The indices of the points
+ * with plane value > threshold are written, compacted, in visible, that must have room for count indices
+ * @return the number of points that see the plane
+ */
+int VisibilityKernels::classifyIndices(const FacePlane& plane, const PointBuffer& points, const int* indices, int count, double threshold, int* visible){
+    return getKernels().classifyIndices(plane, points.getX(), points.getY(), points.getZ(), indices, count, threshold, visible);
+}
+
+/**
+ * @brief VisibilityKernels::getInstructionSet()
+ * This method return the name of the instruction set used by the kernels ("avx512", "avx2", "sse2" or "scalar")
+ */
+const char* VisibilityKernels::getInstructionSet(){
+    return getKernels().instructionSet;
+}
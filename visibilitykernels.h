@@ -0,0 +1,36 @@
+#ifndef VISIBILITYKERNELS_H
+#define VISIBILITYKERNELS_H
+
+#include "pointbuffer.h"
+
+/*********************************************************************
+ * Convex Hull Algorithm, developed by Sergio Serusi                 *
+ *********************************************************************
+ *                                                                   *
+ * Kernel che classificano un blocco di punti rispetto al piano di   *
+ * una faccia e restituiscono, compattati, gli indici dei punti che  *
+ * vedono la faccia. La versione (SSE2, AVX2, AVX-512 o scalare)     *
+ * viene scelta a runtime in base alla CPU; tutte valutano il piano  *
+ * con le stesse operazioni, quindi danno lo stesso risultato.       *
+ *********************************************************************/
+
+//Piano di una faccia: normale (non normalizzata, regola della mano destra sugli half edge) e offset,
+//il punto p vede la faccia se a*p.x + b*p.y + c*p.z + d > 0. Se il valore calcolato in double ha modulo
+//non maggiore di errorBound il segno non è certo e va deciso con il predicato esatto
+struct FacePlane{
+    double a, b, c, d;
+    double errorBound;
+};
+
+class VisibilityKernels{
+
+public:
+    static FacePlane computePlane(const Pointd& p0, const Pointd& p1, const Pointd& p2, double maxAbsCoordinate);
+    static double evaluate(const FacePlane& plane, const PointBuffer& points, int point);
+    static int classifyRange(const FacePlane& plane, const PointBuffer& points, int begin, int end, double threshold, int* visible);
+    static int classifyIndices(const FacePlane& plane, const PointBuffer& points, const int* indices, int count, double threshold, int* visible);
+    static const char* getInstructionSet();
+
+};
+
+#endif // VISIBILITYKERNELS_H